@@ -0,0 +1,72 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "benchgraph.h"
+
+static unsigned long long benchseed;
+
+// xorshift64*, the same sequence on every platform
+static unsigned long benchrand(unsigned long n)
+{
+    benchseed ^= benchseed >> 12;
+    benchseed ^= benchseed << 25;
+    benchseed ^= benchseed >> 27;
+
+    return (unsigned long)((benchseed * 2685821657736338717ULL) >> 33) % n;
+}
+
+double benchnow(void)
+{
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+int benchgraph(symtree_t *ptree, symtree_node_t ***pnodes, int nodeno, int deg, unsigned long long seed)
+{
+    symtree_node_t **nodes;
+    int *callee;
+    long callno = 0;
+    char name[32], file[32];
+    int i, k, w;
+
+    benchseed = seed;
+    nodes = (symtree_node_t **)malloc(nodeno * sizeof(symtree_node_t *));
+    callee = (int *)malloc(((long)nodeno * deg + 1) * sizeof(int));
+    if (nodes == NULL || callee == NULL) {
+        free(nodes);
+        free(callee);
+        return -1;
+    }
+
+    for (i = 0; i < nodeno; i++) {
+        snprintf(name, sizeof(name), "f%d", i);
+        snprintf(file, sizeof(file), "m%d.c", i / 100);
+        nodes[i] = symtree_add(ptree, name, file);
+        if (nodes[i] == NULL)
+            return -1;
+        for (k = 0; i > 0 && k < deg; k++) {
+            if (callno == 0 || benchrand(2) == 0)
+                w = (int)benchrand(i);
+            else
+                w = callee[benchrand(callno)];
+            callee[callno++] = w;
+            symtree_node_add_branch(nodes[i], nodes[w]);
+        }
+    }
+
+    free(callee);
+    *pnodes = nodes;
+
+    return 0;
+}
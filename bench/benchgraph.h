@@ -0,0 +1,21 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _BENCHGRAPH_H
+#define _BENCHGRAPH_H
+
+#include "../symtree.h"
+
+// Synthetic call graph of the benchmarks: function i, defined in file
+// m<i / 100>.c, calls deg functions defined before it, half of them picked at
+// random and half by preferential attachment (the callee of a random call),
+// which gives a few functions called from nearly everywhere, as in real code.
+// The graph only depends on the arguments. nodes[i] receives function i.
+int benchgraph(symtree_t *ptree, symtree_node_t ***pnodes, int nodeno, int deg, unsigned long long seed);
+double benchnow(void);
+
+#endif //  _BENCHGRAPH_H
@@ -0,0 +1,121 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+// Timing of the graphviz output phase on the synthetic graph of benchgraph.h:
+// every function and every call are written through outnode_gra and
+// outbranch_gra, as plain statements, highlighted (-s), in clusters (-F), with
+// the file labels (-f) and on 4 threads (-j), to the given file (default
+// /dev/null, so that only the formatting is timed).
+//
+//   make bench && bench/outbench [<functions> [<calls per function> [<seed> [<file>]]]]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../outgraphviz.h"
+#include "../symtree.h"
+#include "benchgraph.h"
+
+#define BENCH_REPEAT 5 // best of the runs
+
+typedef struct benchcase_st {
+    const char *name;
+    int icolor;     // color of every function
+    int doclusters; // -F option
+    int printfile;  // -f option
+    int jobs;       // -j option
+} benchcase_t;
+
+// write the whole graph once, returning the time taken or -1 on error
+static double benchout(symtree_t *ptree, treeparam_t *pparam)
+{
+    symtree_node_t *pnode;
+    symtree_list_t *plist;
+    double t;
+    int iErr;
+
+    t = benchnow();
+    outselect_gra(0);
+    iErr = outopen_gra(ptree, pparam);
+    for (pnode = symtree_first(ptree); iErr == 0 && pnode != NULL; pnode = symtree_next(pnode)) {
+        iErr = outnode_gra(pnode, pparam);
+        for (plist = pnode->children; iErr == 0 && plist != NULL; plist = plist->next)
+            iErr = outbranch_gra(pnode, plist->symbol, pparam, 0);
+    }
+    if (outclose_gra(ptree, pparam) != 0 || iErr != 0)
+        return -1;
+
+    return benchnow() - t;
+}
+
+int main(int argc, char *argv[])
+{
+    static const benchcase_t cases[] = {
+        { "plain", 0, 0, 0, 1 },
+        { "highlighted -s", 1, 0, 0, 1 },
+        { "-F clusters", 0, 1, 0, 1 },
+        { "-f file labels", 0, 0, 1, 1 },
+        { "plain -j 4", 0, 0, 0, 4 },
+        { "-F clusters -j 4", 0, 1, 0, 4 },
+    };
+    symtree_t tree;
+    symtree_node_t **nodes;
+    symtree_node_t *pnode;
+    symtree_list_t *plist;
+    treeparam_t param;
+    int nodeno = argc > 1 ? atoi(argv[1]) : 200000;
+    int deg = argc > 2 ? atoi(argv[2]) : 10;
+    unsigned long long seed = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    double best, t;
+    long callno = 0;
+    int c, r;
+
+    if (nodeno < 2 || deg < 1 || seed == 0) {
+        printf("\nUsage: outbench [<functions> [<calls per function> [<seed> [<file>]]]]\n");
+        return 1;
+    }
+
+    symtree_init(&tree);
+    if (benchgraph(&tree, &nodes, nodeno, deg, seed) != 0) {
+        printf("\nMemory allocation error\n");
+        return 1;
+    }
+    for (pnode = symtree_first(&tree); pnode != NULL; pnode = symtree_next(pnode))
+        for (plist = pnode->children; plist != NULL; plist = plist->next)
+            callno++;
+
+    memset(&param, 0, sizeof(treeparam_t));
+    param.outfile = argc > 4 ? argv[4] : "/dev/null";
+
+    printf("%d functions, %ld calls written to %s\n", nodeno, callno, param.outfile);
+    printf("case                    time (s, best of %d)\n", BENCH_REPEAT);
+    for (c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); c++) {
+        param.doclusters = cases[c].doclusters;
+        param.printfile = cases[c].printfile;
+        param.jobs = cases[c].jobs;
+        for (pnode = symtree_first(&tree); pnode != NULL; pnode = symtree_next(pnode))
+            pnode->icolor = cases[c].icolor;
+
+        best = 1e9;
+        for (r = 0; r < BENCH_REPEAT; r++) {
+            t = benchout(&tree, &param);
+            if (t < 0) {
+                printf("\nCannot write %s\n", param.outfile);
+                return 1;
+            }
+            if (t < best)
+                best = t;
+        }
+        printf("%-22s  %8.3f\n", cases[c].name, best);
+    }
+
+    free(nodes);
+    symtree_free(&tree);
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+// Timing of the traversals of the frozen call graph for 1 to 64 threads, on the
+// synthetic graph of benchgraph.h. The traversals are timed again on one thread
+// with the graph renumbered by symgraph_relabel, with the hardware cache misses
+// where the system counts them (Linux perf events).
+//
+//   make bench && bench/travbench [<functions> [<calls per function> [<seed>]]]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif // __linux__
+
+#include "../parmark.h"
+#include "../symgraph.h"
+#include "../symtree.h"
+#include "benchgraph.h"
+
+#define BENCH_REPEAT 5 // best of the runs
+
+// counter of the hardware cache misses of this thread, -1 if not available
+static int benchcounter(void)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif // __linux__
+}
+
+static void benchcount(int fd, int start, long long *misses)
+{
+#ifdef __linux__
+    if (fd < 0)
+        return;
+    if (start) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    } else {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd, misses, sizeof(long long)) != sizeof(long long))
+            *misses = -1;
+    }
+#endif // __linux__
+}
+
+// best time and cache misses of the traversals with one job: pardist toward
+// the callees and the callers, parmark toward the callers
+static void benchlayout(symgraph_t *pgraph, int *src, int fd, const char *layout)
+{
+    int *dist;
+    char *mark;
+    double best[3], t;
+    long long misses[3];
+    int r, k;
+
+    dist = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    mark = (char *)malloc(pgraph->nodeno + 1);
+    if (dist == NULL || mark == NULL) {
+        printf("\nMemory allocation error\n");
+        exit(1);
+    }
+
+    for (k = 0; k < 3; k++) {
+        best[k] = 1e9;
+        misses[k] = -1;
+        for (r = 0; r < BENCH_REPEAT; r++) {
+            benchcount(fd, 1, &misses[k]);
+            t = benchnow();
+            if (k < 2)
+                pardist(pgraph, NULL, &src[k], 1, k == 0, -1, 1, dist);
+            else
+                parmark(pgraph, NULL, &src[1], 1, 0, 1, mark);
+            t = benchnow() - t;
+            benchcount(fd, 0, &misses[k]);
+            if (t < best[k])
+                best[k] = t;
+        }
+    }
+
+    printf("%-9s", layout);
+    for (k = 0; k < 3; k++) {
+        if (misses[k] >= 0)
+            printf("  %7.2f ms %9lld", best[k] * 1e3, misses[k]);
+        else
+            printf("  %7.2f ms %9s", best[k] * 1e3, "n/a");
+    }
+    printf("\n");
+
+    free(dist);
+    free(mark);
+}
+
+int main(int argc, char *argv[])
+{
+    static const int jobs[] = { 1, 2, 4, 8, 16, 32, 64 };
+    symtree_t tree;
+    symtree_node_t **nodes;
+    symgraph_t graph;
+    int nodeno = argc > 1 ? atoi(argv[1]) : 200000;
+    int deg = argc > 2 ? atoi(argv[2]) : 10;
+    int *dist[2], *ref[2];
+    char *mark, *refmark;
+    double best[3], t;
+    unsigned long long seed = argc > 3 ? strtoull(argv[3], NULL, 10) : 1;
+    int src[2], reached[2], same;
+    int i, j, r, d, fd;
+
+    if (nodeno < 2 || deg < 1 || seed == 0) {
+        printf("\nUsage: travbench [<functions> [<calls per function> [<seed>]]]\n");
+        return 1;
+    }
+
+    symtree_init(&tree);
+    if (benchgraph(&tree, &nodes, nodeno, deg, seed) != 0 || symgraph_build(&graph, &tree) != 0) {
+        printf("\nMemory allocation error\n");
+        return 1;
+    }
+
+    // the callees of the newest function and the callers of the oldest one
+    src[0] = nodes[nodeno - 1]->idx;
+    src[1] = nodes[0]->idx;
+    mark = (char *)malloc(graph.nodeno + 1);
+    refmark = (char *)malloc(graph.nodeno + 1);
+    for (d = 0; d < 2; d++) {
+        dist[d] = (int *)malloc((graph.nodeno + 1) * sizeof(int));
+        ref[d] = (int *)malloc((graph.nodeno + 1) * sizeof(int));
+        if (mark == NULL || refmark == NULL || dist[d] == NULL || ref[d] == NULL) {
+            printf("\nMemory allocation error\n");
+            return 1;
+        }
+        pardist(&graph, NULL, &src[d], 1, d == 0, -1, 1, ref[d]);
+        for (i = 0, reached[d] = 0; i < graph.nodeno; i++)
+            reached[d] += ref[d][i] >= 0;
+    }
+    parmark(&graph, NULL, &src[1], 1, 0, 1, refmark);
+
+    printf("%d functions, %d calls, %ld processors online\n", graph.nodeno, graph.branchno,
+           sysconf(_SC_NPROCESSORS_ONLN));
+    printf("pardist callees: %d reached, pardist and parmark callers: %d reached\n", reached[0], reached[1]);
+    printf("jobs  pardist callees  pardist callers  parmark callers  (ms, best of %d)\n", BENCH_REPEAT);
+
+    for (j = 0; j < (int)(sizeof(jobs) / sizeof(jobs[0])); j++) {
+        same = 1;
+        best[0] = best[1] = best[2] = 1e9;
+        for (r = 0; r < BENCH_REPEAT; r++) {
+            for (d = 0; d < 2; d++) {
+                t = benchnow();
+                pardist(&graph, NULL, &src[d], 1, d == 0, -1, jobs[j], dist[d]);
+                t = benchnow() - t;
+                if (t < best[d])
+                    best[d] = t;
+                same = same && memcmp(dist[d], ref[d], graph.nodeno * sizeof(int)) == 0;
+            }
+            t = benchnow();
+            parmark(&graph, NULL, &src[1], 1, 0, jobs[j], mark);
+            t = benchnow() - t;
+            if (t < best[2])
+                best[2] = t;
+            same = same && memcmp(mark, refmark, graph.nodeno) == 0;
+        }
+        printf("%4d  %15.2f  %15.2f  %15.2f%s\n", jobs[j], best[0] * 1e3, best[1] * 1e3, best[2] * 1e3,
+               same ? "" : "  (results differ from 1 job)");
+    }
+
+    // the same searches, by name and in search order from the sources
+    fd = benchcounter();
+    printf("\nlayout     pardist callees         pardist callers         parmark callers\n");
+    printf("           (1 job, best time of %d runs and cache misses of the last one%s)\n", BENCH_REPEAT,
+           fd < 0 ? ", not counted on this system" : "");
+    benchlayout(&graph, src, fd, "by name");
+    if (symgraph_relabel(&graph, src, 2) != 0)
+        return 1;
+    benchlayout(&graph, src, fd, "relabeled");
+    if (fd >= 0)
+        close(fd);
+
+    for (d = 0; d < 2; d++) {
+        free(dist[d]);
+        free(ref[d]);
+    }
+    free(mark);
+    free(refmark);
+    free(nodes);
+    symgraph_free(&graph);
+    symtree_free(&tree);
+
+    return 0;
+}
@@ -0,0 +1,387 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef TT_NOTHREADS
+#include <pthread.h>
+#endif // TT_NOTHREADS
+
+#ifndef _ALL_IN_ONE
+#include "blasttree.h"
+#include "defines.h"
+#include "outtree.h"
+#include "parmark.h"
+#include "scc.h"
+#include "slib.h"
+#include "symgraph.h"
+#endif // _ALL_IN_ONE
+
+// Each component of the condensed call graph gets a HyperLogLog sketch of the
+// set of functions made of its members and of everything they reach. The
+// sketch of a component is the register-wise maximum of the sketches of its
+// successors plus its own members, so the components are settled level by
+// level starting from the leaves, and those of the same level in parallel.
+// The relative error of the estimates is about 1.04 / sqrt(BLAST_REGS).
+
+#define BLAST_LOGREGS 7                   // log2 of the number of registers of a sketch
+#define BLAST_REGS (1 << BLAST_LOGREGS)   // registers of a sketch
+#define BLAST_CHUNK 64                    // components taken at once by a worker
+
+typedef unsigned char blastreg_t;
+
+typedef struct blastctx {
+    scc_t *pscc;
+    int *adjstart; // components whose sketches are merged into c: adj[adjstart[c] .. adjstart[c + 1] - 1]
+    int *adj;
+    int *order;      // components sorted by level
+    int *levelstart; // components of level l: order[levelstart[l] .. levelstart[l + 1] - 1]
+    int levelno;
+    blastreg_t *sketch;
+    int jobs;
+#ifndef TT_NOTHREADS
+    pthread_mutex_t lock; // guards next and the level barrier
+    pthread_cond_t cond;
+    int next;             // first component of the current level not taken yet
+    int waiting;
+    int generation;
+#endif // TT_NOTHREADS
+} blastctx_t;
+
+// mix a node index into 64 well distributed bits (splitmix64 finalizer)
+static uint64_t blasthash(int i)
+{
+    uint64_t h = (uint64_t)i + 0x9e3779b97f4a7c15ULL;
+
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+
+    return h ^ (h >> 31);
+}
+
+static void blastadd(blastreg_t *psketch, int i)
+{
+    uint64_t h = blasthash(i);
+    int reg = (int)(h >> (64 - BLAST_LOGREGS));
+    int rank = 1;
+
+    // position of the first 1 bit after the register bits
+    for (h <<= BLAST_LOGREGS; rank <= 64 - BLAST_LOGREGS && !(h & 0x8000000000000000ULL); h <<= 1)
+        rank++;
+    if (rank > psketch[reg])
+        psketch[reg] = (blastreg_t)rank;
+}
+
+static double blastestimate(blastreg_t *psketch)
+{
+    double sum = 0.0, est;
+    int zeros = 0, r;
+
+    for (r = 0; r < BLAST_REGS; r++) {
+        sum += ldexp(1.0, -psketch[r]);
+        zeros += (psketch[r] == 0);
+    }
+    est = 0.7213 / (1.0 + 1.079 / BLAST_REGS) * BLAST_REGS * BLAST_REGS / sum;
+
+    // linear counting is more accurate for small sets
+    if (est <= 2.5 * BLAST_REGS && zeros > 0)
+        est = BLAST_REGS * log((double)BLAST_REGS / zeros);
+
+    return est;
+}
+
+static void blastcomp(blastctx_t *ctx, int c)
+{
+    blastreg_t *psketch = ctx->sketch + (size_t)c * BLAST_REGS;
+    blastreg_t *pother;
+    int j, r;
+
+    memset(psketch, 0, BLAST_REGS);
+    for (j = ctx->pscc->memberstart[c]; j < ctx->pscc->memberstart[c + 1]; j++)
+        blastadd(psketch, ctx->pscc->member[j]);
+    for (j = ctx->adjstart[c]; j < ctx->adjstart[c + 1]; j++) {
+        pother = ctx->sketch + (size_t)ctx->adj[j] * BLAST_REGS;
+        for (r = 0; r < BLAST_REGS; r++)
+            if (pother[r] > psketch[r])
+                psketch[r] = pother[r];
+    }
+}
+
+#ifndef TT_NOTHREADS
+
+// the last worker reaching the barrier opens level l
+static void blastbarrier(blastctx_t *ctx, int l)
+{
+    int generation;
+
+    pthread_mutex_lock(&ctx->lock);
+    generation = ctx->generation;
+    if (++ctx->waiting == ctx->jobs) {
+        ctx->waiting = 0;
+        ctx->next = ctx->levelstart[l];
+        ctx->generation++;
+        pthread_cond_broadcast(&ctx->cond);
+    } else {
+        while (generation == ctx->generation)
+            pthread_cond_wait(&ctx->cond, &ctx->lock);
+    }
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+// the workers take the components of a level in chunks
+static void *blastwork(void *arg)
+{
+    blastctx_t *ctx = (blastctx_t *)arg;
+    int l, k, end;
+
+    // wait until all the workers are started
+    pthread_mutex_lock(&ctx->lock);
+    pthread_mutex_unlock(&ctx->lock);
+
+    for (l = 0; l < ctx->levelno; l++) {
+        for (;;) {
+            pthread_mutex_lock(&ctx->lock);
+            k = ctx->next;
+            ctx->next += BLAST_CHUNK;
+            pthread_mutex_unlock(&ctx->lock);
+            if (k >= ctx->levelstart[l + 1])
+                break;
+
+            end = k + BLAST_CHUNK < ctx->levelstart[l + 1] ? k + BLAST_CHUNK : ctx->levelstart[l + 1];
+            for (; k < end; k++)
+                blastcomp(ctx, ctx->order[k]);
+        }
+        blastbarrier(ctx, l + 1);
+    }
+
+    return NULL;
+}
+
+#endif // TT_NOTHREADS
+
+// sketch every component from the components in adj, level 0 being those
+// with no adj; all the adj of c must come before c in visit order
+static int blastrun(blastctx_t *ctx, int *visit)
+{
+    int sccno = ctx->pscc->sccno;
+    int *level = NULL;
+    int i, j, c, l, k;
+#ifndef TT_NOTHREADS
+    pthread_t threads[PARMARK_MAXJOBS];
+    int started = 1;
+#endif // TT_NOTHREADS
+
+    level = (int *)malloc((sccno + 1) * sizeof(int));
+    ctx->order = (int *)malloc((sccno + 1) * sizeof(int));
+    if (level == NULL || ctx->order == NULL) {
+        free(level);
+        return -1;
+    }
+
+    ctx->levelno = 0;
+    for (i = 0; i < sccno; i++) {
+        c = visit[i];
+        level[c] = 0;
+        for (j = ctx->adjstart[c]; j < ctx->adjstart[c + 1]; j++)
+            if (level[ctx->adj[j]] + 1 > level[c])
+                level[c] = level[ctx->adj[j]] + 1;
+        if (level[c] + 1 > ctx->levelno)
+            ctx->levelno = level[c] + 1;
+    }
+
+    // counting sort of the components by level
+    ctx->levelstart = (int *)calloc(ctx->levelno + 2, sizeof(int));
+    if (ctx->levelstart == NULL) {
+        free(level);
+        return -1;
+    }
+    for (c = 0; c < sccno; c++)
+        ctx->levelstart[level[c] + 2]++;
+    for (l = 0; l < ctx->levelno; l++)
+        ctx->levelstart[l + 2] += ctx->levelstart[l + 1];
+    for (c = 0; c < sccno; c++)
+        ctx->order[ctx->levelstart[level[c] + 1]++] = c;
+    free(level);
+
+#ifndef TT_NOTHREADS
+    if (ctx->jobs > 1) {
+        pthread_mutex_init(&ctx->lock, NULL);
+        pthread_cond_init(&ctx->cond, NULL);
+        ctx->next = 0;
+        ctx->waiting = 0;
+        ctx->generation = 0;
+
+        // the calling thread is a worker too
+        pthread_mutex_lock(&ctx->lock);
+        for (; started < ctx->jobs; started++)
+            if (pthread_create(&threads[started], NULL, blastwork, ctx) != 0)
+                break;
+        ctx->jobs = started;
+        pthread_mutex_unlock(&ctx->lock);
+
+        blastwork(ctx);
+        for (i = 1; i < started; i++)
+            pthread_join(threads[i], NULL);
+        pthread_cond_destroy(&ctx->cond);
+        pthread_mutex_destroy(&ctx->lock);
+    } else
+#endif // TT_NOTHREADS
+    {
+        for (k = 0; k < sccno; k++)
+            blastcomp(ctx, ctx->order[k]);
+    }
+
+    free(ctx->levelstart);
+    free(ctx->order);
+
+    return 0;
+}
+
+// estimate the size of the set sketched for every component, leaving out the
+// component itself unless it is recursive
+static void blastcount(scc_t *pscc, blastreg_t *psketch, double *pcount)
+{
+    int c;
+
+    for (c = 0; c < pscc->sccno; c++) {
+        pcount[c] = blastestimate(psketch + (size_t)c * BLAST_REGS);
+        if (!pscc->recursive[c])
+            pcount[c] = pcount[c] > 1.0 ? pcount[c] - 1.0 : 0.0;
+    }
+}
+
+// estimate for each function how many functions it calls and how many call it,
+// directly or indirectly
+int blasttree(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t graph;
+    scc_t scc;
+    blastctx_t ctx;
+    symtree_node_t *pnode;
+    char *keep = NULL;
+    int *visit = NULL;
+    int *predstart = NULL, *pred = NULL;
+    double *reaches = NULL, *reachedby = NULL;
+    int i, j, c, first = 1;
+    clock_t tstart = clock();
+
+    iErr = symgraph_build(&graph, ptree);
+    if (iErr != 0)
+        return iErr;
+
+    // excluded functions (-x option) are neither crossed nor counted
+    keep = (char *)malloc(graph.nodeno + 1);
+    if (keep == NULL) {
+        printf("\nMemory allocation error\n");
+        symgraph_free(&graph);
+        return -1;
+    }
+    for (i = 0; i < graph.nodeno; i++)
+        keep[i] = !outexcluded(graph.nodes[i], pparam);
+    iErr = scc_build(&scc, &graph, keep);
+    free(keep);
+    if (iErr != 0) {
+        symgraph_free(&graph);
+        return iErr;
+    }
+
+    memset(&ctx, 0, sizeof(blastctx_t));
+    ctx.pscc = &scc;
+    ctx.jobs = pparam->jobs > PARMARK_MAXJOBS ? PARMARK_MAXJOBS : pparam->jobs;
+#ifdef TT_NOTHREADS
+    ctx.jobs = 1;
+#endif // TT_NOTHREADS
+    ctx.sketch = (blastreg_t *)malloc(((size_t)scc.sccno + 1) * BLAST_REGS);
+    visit = (int *)malloc((scc.sccno + 1) * sizeof(int));
+    predstart = (int *)calloc(scc.sccno + 2, sizeof(int));
+    pred = (int *)malloc((scc.succstart[scc.sccno] + 1) * sizeof(int));
+    reaches = (double *)malloc((scc.sccno + 1) * sizeof(double));
+    reachedby = (double *)malloc((scc.sccno + 1) * sizeof(double));
+    if (ctx.sketch == NULL || visit == NULL || predstart == NULL || pred == NULL || reaches == NULL || reachedby == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
+
+    if (iErr == 0) {
+        // callees: successors have lower indexes
+        for (c = 0; c < scc.sccno; c++)
+            visit[c] = c;
+        ctx.adjstart = scc.succstart;
+        ctx.adj = scc.succ;
+        iErr = blastrun(&ctx, visit);
+    }
+
+    if (iErr == 0) {
+        blastcount(&scc, ctx.sketch, reaches);
+
+        // callers: predecessors, from the transposed condensed graph
+        for (c = 0; c < scc.sccno; c++)
+            for (j = scc.succstart[c]; j < scc.succstart[c + 1]; j++)
+                predstart[scc.succ[j] + 2]++;
+        for (c = 0; c < scc.sccno; c++)
+            predstart[c + 2] += predstart[c + 1];
+        for (c = 0; c < scc.sccno; c++)
+            for (j = scc.succstart[c]; j < scc.succstart[c + 1]; j++)
+                pred[predstart[scc.succ[j] + 1]++] = c;
+        for (c = 0; c < scc.sccno; c++)
+            visit[c] = scc.sccno - 1 - c;
+        ctx.adjstart = predstart;
+        ctx.adj = pred;
+        iErr = blastrun(&ctx, visit);
+    }
+
+    if (iErr == 0) {
+        blastcount(&scc, ctx.sketch, reachedby);
+
+        if (pparam->json)
+            printf("[");
+        else
+            printf("# function\tfile\treaches\treachedby\n");
+        for (i = 0; i < graph.nodeno; i++) {
+            c = scc.comp[i];
+            if (c < 0)
+                continue;
+            pnode = graph.nodes[i];
+            if (pparam->json) {
+                printf("%s\n  {\"function\": ", first ? "" : ",");
+                slibjson(stdout, pnode->funname);
+                printf(", \"file\": ");
+                slibjson(stdout, pnode->filename);
+                printf(", \"reaches\": %.0f, \"reachedby\": %.0f}", reaches[c], reachedby[c]);
+            } else {
+                printf("%s\t%s\t%.0f\t%.0f\n", pnode->funname, pnode->filename ? pnode->filename : TT_LIBRARY,
+                    reaches[c], reachedby[c]);
+            }
+            first = 0;
+        }
+        if (pparam->json)
+            printf("\n]\n");
+
+        if (pparam->verbose)
+            printf("\n%d functions, %d components, estimated in %.3f s\n",
+                graph.nodeno, scc.sccno, (double)(clock() - tstart) / CLOCKS_PER_SEC);
+    } else if (ctx.sketch != NULL) {
+        printf("\nMemory allocation error\n");
+    }
+
+    free(ctx.sketch);
+    free(visit);
+    free(predstart);
+    free(pred);
+    free(reaches);
+    free(reachedby);
+    scc_free(&scc);
+    symgraph_free(&graph);
+
+    return iErr;
+}
@@ -0,0 +1,18 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _BLASTTREE_H
+#define _BLASTTREE_H
+
+#ifndef _ALL_IN_ONE
+#include "symtree.h"
+#include "ttreeparam.h"
+#endif // _ALL_IN_ONE
+
+int blasttree(symtree_t *ptree, treeparam_t *pparam);
+
+#endif // #ifndef _BLASTTREE_H
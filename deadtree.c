@@ -0,0 +1,162 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _ALL_IN_ONE
+#include "deadtree.h"
+#include "defines.h"
+#include "outtree.h"
+#include "parmark.h"
+#include "symgraph.h"
+#endif // _ALL_IN_ONE
+
+#define MAXLINER 1024 // maximum length of a line in the entry points file
+
+typedef struct deadroots {
+    int *idx;
+    int no;
+    int maxno;
+} deadroots_t;
+
+// add all the definitions of function funname to the entry points
+static int addroot(symtree_t *ptree, deadroots_t *proots, char *funname, int verbose)
+{
+    symtree_node_t *pnode;
+    int *grown;
+
+    pnode = symtree_find_first(ptree, funname);
+    if (pnode == NULL && verbose)
+        printf("\nUnknown entry point: %s\n", funname);
+
+    // the same function name may be defined in several files
+    for (; pnode && strcmp(pnode->funname, funname) == 0; pnode = symtree_next(pnode)) {
+        if (proots->no == proots->maxno) {
+            grown = (int *)realloc(proots->idx, (2 * proots->maxno + 64) * sizeof(int));
+            if (grown == NULL) {
+                printf("\nMemory allocation error\n");
+                return -1;
+            }
+            proots->idx = grown;
+            proots->maxno = 2 * proots->maxno + 64;
+        }
+        proots->idx[proots->no++] = pnode->idx;
+    }
+
+    return 0;
+}
+
+static symgraph_t *psortgraph; // graph of the nodes being sorted
+
+// order by file, then by function name
+static int cmpbyfile(const void *a, const void *b)
+{
+    symtree_node_t *pa = psortgraph->nodes[*(const int *)a];
+    symtree_node_t *pb = psortgraph->nodes[*(const int *)b];
+    int res = strcmp(pa->filename, pb->filename);
+
+    return res != 0 ? res : strcmp(pa->funname, pb->funname);
+}
+
+// list the functions defined in a file that cannot be reached from the roots
+// (-r options) nor from the entry points listed in the roots file
+int deadtree(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    FILE *filer;
+    symgraph_t graph;
+    deadroots_t roots;
+    char sLine[MAXLINER];
+    char *funname;
+    char *keep = NULL;
+    char *mark = NULL;
+    int *dead = NULL;
+    int deadno = 0, i;
+    clock_t tstart = clock();
+
+    iErr = symgraph_build(&graph, ptree);
+    if (iErr != 0)
+        return iErr;
+
+    memset(&roots, 0, sizeof(deadroots_t));
+    for (i = 0; iErr == 0 && i < pparam->rootno; i++)
+        iErr = addroot(ptree, &roots, pparam->root[i], pparam->verbose);
+
+    if (iErr == 0) {
+        filer = fopen(pparam->rootfile, "r");
+        if (filer == NULL) {
+            printf("\nError while opening roots file\n");
+            iErr = -1;
+        } else {
+            // one function name per line
+            while (iErr == 0 && fgets(sLine, MAXLINER, filer) != NULL) {
+                funname = strtok(sLine, " \t\r\n");
+                if (funname != NULL && funname[0] != '#')
+                    iErr = addroot(ptree, &roots, funname, pparam->verbose);
+            }
+
+            if (fclose(filer) != 0) {
+                printf("\nError while closing roots file\n");
+                iErr = -1;
+            }
+        }
+    }
+
+    // the sweep from the entry points touches nearby memory
+    if (iErr == 0)
+        iErr = symgraph_relabel(&graph, roots.idx, roots.no);
+
+    if (iErr == 0) {
+        keep = (char *)malloc(graph.nodeno + 1);
+        mark = (char *)malloc(graph.nodeno + 1);
+        dead = (int *)malloc((graph.nodeno + 1) * sizeof(int));
+        if (keep == NULL || mark == NULL || dead == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        }
+    }
+
+    if (iErr == 0) {
+        // excluded functions (-x option) are neither crossed nor reported
+        for (i = 0; i < graph.nodeno; i++)
+            keep[i] = !outexcluded(graph.nodes[i], pparam);
+
+        // one sweep from all the entry points together
+        iErr = parmark(&graph, keep, roots.idx, roots.no, 1, pparam->jobs, mark);
+    }
+
+    if (iErr == 0) {
+        for (i = 0; i < graph.nodeno; i++)
+            if (keep[i] && !mark[i] && graph.nodes[i]->filename != NULL)
+                dead[deadno++] = i;
+
+        psortgraph = &graph;
+        qsort(dead, deadno, sizeof(int), cmpbyfile);
+
+        // file name, then its unreachable functions indented below
+        for (i = 0; i < deadno; i++) {
+            if (i == 0 || strcmp(graph.nodes[dead[i]]->filename, graph.nodes[dead[i - 1]]->filename) != 0)
+                printf("%s\n", graph.nodes[dead[i]]->filename);
+            printf("\t%s\n", graph.nodes[dead[i]]->funname);
+        }
+
+        if (pparam->verbose)
+            printf("\n%d unreachable functions from %d entry points, found in %.3f s\n",
+                deadno, roots.no, (double)(clock() - tstart) / CLOCKS_PER_SEC);
+    }
+
+    free(roots.idx);
+    free(keep);
+    free(mark);
+    free(dead);
+    symgraph_free(&graph);
+
+    return iErr;
+}
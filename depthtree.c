@@ -0,0 +1,127 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _ALL_IN_ONE
+#include "defines.h"
+#include "depthtree.h"
+#include "outtree.h"
+#include "scc.h"
+#include "symgraph.h"
+#endif // _ALL_IN_ONE
+
+#define MAXCYCLEMEMBERS 8 // members of a recursive cycle listed in a chain
+
+// print the example chain starting from component c: it follows the deepest
+// callee and ends at the first recursive cycle, printed as [member ...]
+static void printchain(symgraph_t *pgraph, scc_t *pscc, int *next, int c)
+{
+    int m, size;
+
+    for (; c >= 0; c = next[c]) {
+        if (pscc->recursive[c]) {
+            size = pscc->memberstart[c + 1] - pscc->memberstart[c];
+            printf("[");
+            for (m = 0; m < size && m < MAXCYCLEMEMBERS; m++)
+                printf("%s%s", m > 0 ? " " : "", pgraph->nodes[pscc->member[pscc->memberstart[c] + m]]->funname);
+            if (size > MAXCYCLEMEMBERS)
+                printf(" ... %d functions", size);
+            printf("]");
+            break;
+        }
+        printf("%s", pgraph->nodes[pscc->member[pscc->memberstart[c]]]->funname);
+        if (next[c] >= 0)
+            printf(" -> ");
+    }
+}
+
+// worst-case call chain depth from each root, for stack budget analysis
+int depthtree(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t graph;
+    scc_t scc;
+    symtree_node_t *pnode;
+    char *keep = NULL;
+    char *unbounded = NULL;
+    int *depth = NULL;
+    int *next = NULL;
+    int i, c, d, j, best;
+
+    iErr = symgraph_build(&graph, ptree);
+    if (iErr != 0)
+        return iErr;
+
+    // excluded functions (-x option) are not followed
+    keep = (char *)malloc(graph.nodeno + 1);
+    if (keep == NULL) {
+        printf("\nMemory allocation error\n");
+        symgraph_free(&graph);
+        return -1;
+    }
+    for (i = 0; i < graph.nodeno; i++)
+        keep[i] = !outexcluded(graph.nodes[i], pparam);
+
+    iErr = scc_build(&scc, &graph, keep);
+    free(keep);
+    if (iErr != 0) {
+        symgraph_free(&graph);
+        return iErr;
+    }
+
+    depth = (int *)malloc((scc.sccno + 1) * sizeof(int));
+    next = (int *)malloc((scc.sccno + 1) * sizeof(int));
+    unbounded = (char *)malloc(scc.sccno + 1);
+    if (depth == NULL || next == NULL || unbounded == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    } else {
+        // components come successors first, so one pass settles the longest chain below
+        // each of them; a chain reaching a recursive cycle has no bound
+        for (c = 0; c < scc.sccno; c++) {
+            best = -1;
+            for (j = scc.succstart[c]; j < scc.succstart[c + 1]; j++) {
+                d = scc.succ[j];
+                if (best < 0 || unbounded[d] > unbounded[best] || (unbounded[d] == unbounded[best] && depth[d] > depth[best]))
+                    best = d;
+            }
+            next[c] = best;
+            depth[c] = best < 0 ? 0 : depth[best] + 1;
+            unbounded[c] = scc.recursive[c] || (best >= 0 && unbounded[best]);
+        }
+
+        printf("# root\tdepth\tchain\n");
+        for (i = 0; i < graph.nodeno; i++) {
+            pnode = graph.nodes[i];
+            for (j = 0; j < pparam->rootno; j++)
+                if (strcmp(pnode->funname, pparam->root[j]) == 0)
+                    break;
+            if (j == pparam->rootno || scc.comp[i] < 0)
+                continue;
+
+            // the same function can have multiple definitions in different files
+            c = scc.comp[i];
+            if (unbounded[c])
+                printf("%s\tunbounded\t", pnode->funname);
+            else
+                printf("%s\t%d\t", pnode->funname, depth[c]);
+            printchain(&graph, &scc, next, c);
+            printf("\n");
+        }
+    }
+
+    free(depth);
+    free(next);
+    free(unbounded);
+    scc_free(&scc);
+    symgraph_free(&graph);
+
+    return iErr;
+}
@@ -0,0 +1,278 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _ALL_IN_ONE
+#include "defines.h"
+#include "difftree.h"
+#include "dobfs.h"
+#include "gettree.h"
+#include "outtree.h"
+#include "symgraph.h"
+#endif // _ALL_IN_ONE
+
+// One of the two call graphs being compared. Both are numbered in the order
+// of their symtree, i.e. by function name and file name, so merging the two
+// node lists gives shared ids that keep the same order on both sides.
+typedef struct diffside {
+    symgraph_t graph;
+    int *sid;    // shared id of each node
+    int *callee; // callees of i sorted by id: callee[graph.childstart[i] .. graph.childstart[i + 1] - 1]
+} diffside_t;
+
+// same order as the symtree: by function name, then file name, library functions last
+static int cmpnode(symtree_node_t *pa, symtree_node_t *pb)
+{
+    int res = strcmp(pa->funname, pb->funname);
+
+    if (res != 0)
+        return res;
+    if (pa->filename == NULL || pb->filename == NULL)
+        return (pa->filename == NULL) - (pb->filename == NULL);
+
+    return strcmp(pa->filename, pb->filename);
+}
+
+static int diffsideinit(diffside_t *pside, symtree_t *ptree)
+{
+    int *pos;
+    int i, j, c;
+
+    memset(pside, 0, sizeof(diffside_t));
+    if (symgraph_build(&pside->graph, ptree) != 0)
+        return -1;
+
+    pside->sid = (int *)malloc((pside->graph.nodeno + 1) * sizeof(int));
+    pside->callee = (int *)malloc((pside->graph.branchno + 1) * sizeof(int));
+    pos = (int *)malloc((pside->graph.nodeno + 1) * sizeof(int));
+    if (pside->sid == NULL || pside->callee == NULL || pos == NULL) {
+        printf("\nMemory allocation error\n");
+        free(pos);
+        return -1;
+    }
+
+    // the caller lists are sorted, so transposing them again sorts the callee lists
+    memcpy(pos, pside->graph.childstart, pside->graph.nodeno * sizeof(int));
+    for (c = 0; c < pside->graph.nodeno; c++)
+        for (j = pside->graph.parentstart[c]; j < pside->graph.parentstart[c + 1]; j++) {
+            i = pside->graph.parent[j];
+            pside->callee[pos[i]++] = c;
+        }
+    free(pos);
+
+    return 0;
+}
+
+static void diffsidefree(diffside_t *pside)
+{
+    free(pside->sid);
+    free(pside->callee);
+    symgraph_free(&pside->graph);
+}
+
+// flag with shared ids the functions within -c/-C depth of the roots
+static int diffscope(diffside_t *pside, symtree_t *ptree, treeparam_t *pparam, char *scope)
+{
+    symgraph_t *pgraph = &pside->graph;
+    symtree_node_t *pnode;
+    char *keep;
+    int *src, *dist;
+    int iErr = 0, srcno = 0, dir, i;
+
+    keep = (char *)malloc(pgraph->nodeno + 1);
+    src = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    dist = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    if (keep == NULL || src == NULL || dist == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    } else {
+        for (i = 0; i < pgraph->nodeno; i++)
+            keep[i] = !outexcluded(pgraph->nodes[i], pparam);
+        for (i = 0; i < pparam->rootno; i++) {
+            // the same function name may be defined in several files
+            for (pnode = symtree_find_first(ptree, pparam->root[i]); pnode && strcmp(pnode->funname, pparam->root[i]) == 0;
+                 pnode = symtree_next(pnode))
+                src[srcno++] = pnode->idx;
+        }
+
+        // callees first, then callers
+        for (dir = 0; iErr == 0 && dir < 2; dir++) {
+            iErr = dobfs(pgraph, keep, src, srcno, dir == 0, dir == 0 ? pparam->fdepth : pparam->bdepth, dist);
+            for (i = 0; iErr == 0 && i < pgraph->nodeno; i++)
+                if (dist[i] >= 0)
+                    scope[pside->sid[i]] = 1;
+        }
+    }
+
+    free(keep);
+    free(src);
+    free(dist);
+
+    return iErr;
+}
+
+static void printnode(symtree_node_t *pnode, treeparam_t *pparam)
+{
+    if (pparam->printfile)
+        printf("%s (%s)", pnode->funname, pnode->filename ? pnode->filename : TT_LIBRARY);
+    else
+        printf("%s", pnode->funname);
+}
+
+static void printcall(char sign, symtree_node_t *pcaller, symtree_node_t *pcallee, treeparam_t *pparam)
+{
+    printf("%ccall ", sign);
+    printnode(pcaller, pparam);
+    printf(" -> ");
+    printnode(pcallee, pparam);
+    printf("\n");
+}
+
+// compare the calls of the input file (new) with the ones of the diff file (old)
+int difftree(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    treeparam_t oldparam;
+    symtree_t oldtree;
+    diffside_t oldside, newside;
+    int *oldof = NULL, *newof = NULL; // node of each shared id on each side, -1 if missing
+    char *scope = NULL;
+    int sidno = 0, s, i, j, o, n, oend, nend, cmp;
+    long addno = 0, delno = 0;
+    clock_t tstart = clock();
+
+    // read the old file the same way as the new one, but without -d output
+    oldparam = *pparam;
+    oldparam.infile = pparam->difffile;
+    oldparam.shortdbfile = "";
+    symtree_init(&oldtree);
+    iErr = gettree(&oldtree, &oldparam);
+
+    memset(&oldside, 0, sizeof(diffside_t));
+    memset(&newside, 0, sizeof(diffside_t));
+    if (iErr == 0)
+        iErr = diffsideinit(&oldside, &oldtree);
+    if (iErr == 0)
+        iErr = diffsideinit(&newside, ptree);
+
+    if (iErr == 0) {
+        oldof = (int *)malloc((oldside.graph.nodeno + newside.graph.nodeno + 1) * sizeof(int));
+        newof = (int *)malloc((oldside.graph.nodeno + newside.graph.nodeno + 1) * sizeof(int));
+        scope = (char *)malloc(oldside.graph.nodeno + newside.graph.nodeno + 1);
+        if (oldof == NULL || newof == NULL || scope == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        }
+    }
+
+    if (iErr == 0) {
+        // shared ids: merge of the two sorted node lists
+        for (i = 0, j = 0; i < oldside.graph.nodeno || j < newside.graph.nodeno; sidno++) {
+            if (i == oldside.graph.nodeno)
+                cmp = 1;
+            else if (j == newside.graph.nodeno)
+                cmp = -1;
+            else
+                cmp = cmpnode(oldside.graph.nodes[i], newside.graph.nodes[j]);
+            oldof[sidno] = cmp <= 0 ? i : -1;
+            newof[sidno] = cmp >= 0 ? j : -1;
+            if (cmp <= 0)
+                oldside.sid[i++] = sidno;
+            if (cmp >= 0)
+                newside.sid[j++] = sidno;
+        }
+
+        // without -r roots every function is compared
+        memset(scope, pparam->rootno == 0, sidno);
+        if (pparam->rootno > 0) {
+            iErr = diffscope(&oldside, &oldtree, pparam, scope);
+            if (iErr == 0)
+                iErr = diffscope(&newside, ptree, pparam, scope);
+        }
+
+        // excluded functions (-x option) are left out on both sides
+        for (s = 0; s < sidno; s++)
+            if ((oldof[s] >= 0 && outexcluded(oldside.graph.nodes[oldof[s]], pparam))
+                || (newof[s] >= 0 && outexcluded(newside.graph.nodes[newof[s]], pparam)))
+                scope[s] = 0;
+    }
+
+    if (iErr == 0) {
+        for (s = 0; s < sidno; s++) {
+            if (!scope[s] || (oldof[s] >= 0 && newof[s] >= 0))
+                continue;
+            if (oldof[s] >= 0) {
+                printf("-function ");
+                printnode(oldside.graph.nodes[oldof[s]], pparam);
+                printf("\n");
+                delno++;
+            } else {
+                printf("+function ");
+                printnode(newside.graph.nodes[newof[s]], pparam);
+                printf("\n");
+                addno++;
+            }
+        }
+
+        // calls: merge of the sorted callee lists of each caller
+        for (s = 0; s < sidno; s++) {
+            if (!scope[s])
+                continue;
+            o = n = oend = nend = 0;
+            if (oldof[s] >= 0) {
+                o = oldside.graph.childstart[oldof[s]];
+                oend = oldside.graph.childstart[oldof[s] + 1];
+            }
+            if (newof[s] >= 0) {
+                n = newside.graph.childstart[newof[s]];
+                nend = newside.graph.childstart[newof[s] + 1];
+            }
+            while (o < oend || n < nend) {
+                if (o == oend)
+                    cmp = 1;
+                else if (n == nend)
+                    cmp = -1;
+                else
+                    cmp = oldside.sid[oldside.callee[o]] - newside.sid[newside.callee[n]];
+
+                if (cmp < 0) {
+                    if (scope[oldside.sid[oldside.callee[o]]]) {
+                        printcall('-', oldside.graph.nodes[oldof[s]], oldside.graph.nodes[oldside.callee[o]], pparam);
+                        delno++;
+                    }
+                    o++;
+                } else if (cmp > 0) {
+                    if (scope[newside.sid[newside.callee[n]]]) {
+                        printcall('+', newside.graph.nodes[newof[s]], newside.graph.nodes[newside.callee[n]], pparam);
+                        addno++;
+                    }
+                    n++;
+                } else {
+                    o++;
+                    n++;
+                }
+            }
+        }
+
+        if (pparam->verbose)
+            printf("\n%ld additions and %ld removals over %d functions, found in %.3f s\n",
+                addno, delno, sidno, (double)(clock() - tstart) / CLOCKS_PER_SEC);
+    }
+
+    free(oldof);
+    free(newof);
+    free(scope);
+    diffsidefree(&oldside);
+    diffsidefree(&newside);
+    symtree_free(&oldtree);
+
+    return iErr;
+}
@@ -0,0 +1,115 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dobfs.h"
+
+#define KEPT(keep, i) (!(keep) || (keep)[i])
+
+// Direction-optimizing breadth first search (Beamer et al.). A top-down step
+// scans the edges leaving the frontier; when the frontier gets large, a
+// bottom-up step lets every node not reached yet look for one of its
+// predecessors in the frontier instead, stopping at the first one found.
+// Wide sweeps (e.g. the callers of a low level function) reach most of the
+// graph in a few levels, where bottom-up steps skip most of the edges.
+
+// dist[i] = number of calls from the nearest source to node i following the
+// callees (forward != 0) or the callers, -1 if not reached within maxdepth
+// (-1 = no limit). Nodes with keep[i] == 0 are neither reached nor crossed.
+int dobfs(symgraph_t *graph, const char *keep, const int *src, int srcno, int forward, int maxdepth, int *dist)
+{
+    int *outstart = forward ? graph->childstart : graph->parentstart;
+    int *out = forward ? graph->child : graph->parent;
+    int *instart = forward ? graph->parentstart : graph->childstart;
+    int *in = forward ? graph->parent : graph->child;
+    int *cur, *next, *swap;
+    unsigned char *front; // bitmap of the frontier for the bottom-up steps
+    int curno = 0, nextno, level, bottomup = 0;
+    long frontedges = 0, restedges = 0;
+    int i, j, v, w;
+
+    cur = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    next = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    front = (unsigned char *)calloc(graph->nodeno / 8 + 1, 1);
+    if (cur == NULL || next == NULL || front == NULL) {
+        printf("\nMemory allocation error\n");
+        free(cur);
+        free(next);
+        free(front);
+        return -1;
+    }
+
+    for (i = 0; i < graph->nodeno; i++) {
+        dist[i] = -1;
+        if (KEPT(keep, i))
+            restedges += outstart[i + 1] - outstart[i];
+    }
+    for (i = 0; i < srcno; i++) {
+        v = src[i];
+        if (KEPT(keep, v) && dist[v] < 0) {
+            dist[v] = 0;
+            cur[curno++] = v;
+            frontedges += outstart[v + 1] - outstart[v];
+        }
+    }
+    restedges -= frontedges;
+
+    for (level = 0; curno > 0 && (maxdepth < 0 || level < maxdepth); level++) {
+        if (!bottomup && frontedges > restedges / DOBFS_ALPHA)
+            bottomup = 1;
+        else if (bottomup && curno < graph->nodeno / DOBFS_BETA)
+            bottomup = 0;
+
+        nextno = 0;
+        frontedges = 0;
+        if (bottomup) {
+            // the bitmap is much smaller than dist[], so the random lookups hit the cache
+            memset(front, 0, graph->nodeno / 8 + 1);
+            for (i = 0; i < curno; i++)
+                front[cur[i] >> 3] |= 1 << (cur[i] & 7);
+            for (w = 0; w < graph->nodeno; w++) {
+                if (dist[w] >= 0 || !KEPT(keep, w))
+                    continue;
+                for (j = instart[w]; j < instart[w + 1]; j++) {
+                    if (front[in[j] >> 3] & (1 << (in[j] & 7))) {
+                        dist[w] = level + 1;
+                        next[nextno++] = w;
+                        frontedges += outstart[w + 1] - outstart[w];
+                        break;
+                    }
+                }
+            }
+        } else {
+            for (i = 0; i < curno; i++) {
+                v = cur[i];
+                for (j = outstart[v]; j < outstart[v + 1]; j++) {
+                    w = out[j];
+                    if (dist[w] < 0 && KEPT(keep, w)) {
+                        dist[w] = level + 1;
+                        next[nextno++] = w;
+                        frontedges += outstart[w + 1] - outstart[w];
+                    }
+                }
+            }
+        }
+        restedges -= frontedges;
+
+        swap = cur;
+        cur = next;
+        next = swap;
+        curno = nextno;
+    }
+
+    free(cur);
+    free(next);
+    free(front);
+
+    return 0;
+}
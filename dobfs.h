@@ -0,0 +1,18 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _DOBFS_H
+#define _DOBFS_H
+
+#include "symgraph.h"
+
+#define DOBFS_ALPHA 14 // go bottom-up when the frontier edges exceed 1/ALPHA of the unexplored edges
+#define DOBFS_BETA 24  // go back top-down when the frontier has less than 1/BETA of the nodes
+
+int dobfs(symgraph_t *graph, const char *keep, const int *src, int srcno, int forward, int maxdepth, int *dist);
+
+#endif //  _DOBFS_H
@@ -0,0 +1,249 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "kpath.h"
+
+#define KEPT(keep, i) (!(keep) || (keep)[i])
+
+// A virtual node numbered nodeno comes before the sources, so that paths
+// starting from different sources are deviations of one another.
+
+typedef struct kpathlist {
+    int **path; // path[i][0] is the length, followed by the nodes
+    int no;
+    int maxno;
+} kpathlist_t;
+
+typedef struct kpathctx {
+    symgraph_t *graph;
+    const char *keep;
+    const int *src;
+    int srcno;
+    const char *target;
+    int *start;
+    int *adj;
+    int *seen; // visit stamps
+    int *blocked;
+    int *pred;
+    int *queue;
+    int stamp;
+} kpathctx_t;
+
+static int listadd(kpathlist_t *plist, int *path)
+{
+    int **grown;
+
+    if (plist->no == plist->maxno) {
+        grown = (int **)realloc(plist->path, (2 * plist->maxno + 16) * sizeof(int *));
+        if (grown == NULL)
+            return -1;
+        plist->path = grown;
+        plist->maxno = 2 * plist->maxno + 16;
+    }
+    plist->path[plist->no++] = path;
+
+    return 0;
+}
+
+static int listhas(kpathlist_t *plist, int *path)
+{
+    int i;
+
+    for (i = 0; i < plist->no; i++)
+        if (plist->path[i][0] == path[0] && memcmp(plist->path[i] + 1, path + 1, path[0] * sizeof(int)) == 0)
+            return 1;
+
+    return 0;
+}
+
+static void listfree(kpathlist_t *plist)
+{
+    int i;
+
+    for (i = 0; i < plist->no; i++)
+        free(plist->path[i]);
+    free(plist->path);
+    memset(plist, 0, sizeof(kpathlist_t));
+}
+
+// shortest path from spur to a target avoiding the blocked nodes and the first
+// hops in hop[]; the path is appended to prefix[1 .. prefixno] (the nodes before
+// spur) and returned in a new array, NULL if there is none
+static int *spurpath(kpathctx_t *ctx, int spur, const int *hop, int hopno, const int *prefix, int prefixno)
+{
+    int n = ctx->graph->nodeno;
+    int head = 0, tail = 0, found = -1;
+    int v, w, j, first, last, len;
+    int *path;
+
+    ctx->stamp++;
+    ctx->seen[spur] = ctx->stamp;
+    ctx->queue[tail++] = spur;
+    while (head < tail && found < 0) {
+        v = ctx->queue[head++];
+        first = v == n ? 0 : ctx->start[v];
+        last = v == n ? ctx->srcno : ctx->start[v + 1];
+        for (j = first; j < last; j++) {
+            w = v == n ? ctx->src[j] : ctx->adj[j];
+            if (ctx->seen[w] == ctx->stamp || ctx->blocked[w] == ctx->stamp || !KEPT(ctx->keep, w))
+                continue;
+            if (v == spur) {
+                for (len = 0; len < hopno && hop[len] != w; len++)
+                    ;
+                if (len < hopno)
+                    continue;
+            }
+            ctx->seen[w] = ctx->stamp;
+            ctx->pred[w] = v;
+            if (ctx->target[w]) {
+                found = w;
+                break;
+            }
+            ctx->queue[tail++] = w;
+        }
+    }
+    if (found < 0)
+        return NULL;
+
+    for (len = 1, v = found; v != spur; v = ctx->pred[v])
+        len++;
+    path = (int *)malloc((prefixno + len + 1) * sizeof(int));
+    if (path == NULL)
+        return NULL;
+    path[0] = prefixno + len;
+    if (prefixno > 0)
+        memcpy(path + 1, prefix, prefixno * sizeof(int));
+    for (j = prefixno + len, v = found; j > prefixno; v = ctx->pred[v])
+        path[j--] = v;
+
+    return path;
+}
+
+int kpath_find(kpath_t *paths, symgraph_t *graph, const char *keep, const int *src, int srcno,
+    const char *target, int forward, int k)
+{
+    kpathctx_t ctx;
+    kpathlist_t found, cand;
+    int *prev, *path, *hop = NULL;
+    int n = graph->nodeno;
+    int iErr = 0, i, p, best, hopno, total;
+
+    memset(paths, 0, sizeof(kpath_t));
+    memset(&found, 0, sizeof(kpathlist_t));
+    memset(&cand, 0, sizeof(kpathlist_t));
+    memset(&ctx, 0, sizeof(kpathctx_t));
+    ctx.graph = graph;
+    ctx.keep = keep;
+    ctx.src = src;
+    ctx.srcno = srcno;
+    ctx.target = target;
+    ctx.start = forward ? graph->childstart : graph->parentstart;
+    ctx.adj = forward ? graph->child : graph->parent;
+    ctx.seen = (int *)calloc(n + 1, sizeof(int));
+    ctx.blocked = (int *)calloc(n + 1, sizeof(int));
+    ctx.pred = (int *)malloc((n + 1) * sizeof(int));
+    ctx.queue = (int *)malloc((n + 1) * sizeof(int));
+    if (ctx.seen == NULL || ctx.blocked == NULL || ctx.pred == NULL || ctx.queue == NULL)
+        iErr = -1;
+
+    if (iErr == 0) {
+        path = spurpath(&ctx, n, NULL, 0, NULL, 0);
+        if (path != NULL && listadd(&found, path) != 0) {
+            free(path);
+            iErr = -1;
+        }
+    }
+
+    while (iErr == 0 && found.no > 0 && found.no < k) {
+        prev = found.path[found.no - 1];
+        hop = (int *)realloc(hop, (found.no + 1) * sizeof(int));
+        if (hop == NULL) {
+            iErr = -1;
+            break;
+        }
+
+        // deviate from the last path found at each of its nodes but the target
+        // (prev[1] is the virtual node)
+        for (i = 1; iErr == 0 && i < prev[0]; i++) {
+            // leave out the next hops of the paths sharing the same prefix
+            hopno = 0;
+            for (p = 0; p < found.no; p++)
+                if (found.path[p][0] > i && memcmp(found.path[p] + 1, prev + 1, i * sizeof(int)) == 0)
+                    hop[hopno++] = found.path[p][i + 1];
+
+            // the prefix nodes cannot be crossed again (stamp of the next search)
+            for (p = 1; p < i; p++)
+                ctx.blocked[prev[p]] = ctx.stamp + 1;
+            path = spurpath(&ctx, prev[i], hop, hopno, prev + 1, i - 1);
+            if (path != NULL) {
+                if (listhas(&cand, path) || listhas(&found, path))
+                    free(path);
+                else if (listadd(&cand, path) != 0) {
+                    free(path);
+                    iErr = -1;
+                }
+            }
+        }
+        if (iErr != 0 || cand.no == 0)
+            break;
+
+        // the shortest candidate, the first one among equals
+        for (best = 0, p = 1; p < cand.no; p++)
+            if (cand.path[p][0] < cand.path[best][0])
+                best = p;
+        if (listadd(&found, cand.path[best]) != 0) {
+            iErr = -1;
+            break;
+        }
+        memmove(cand.path + best, cand.path + best + 1, (cand.no - best - 1) * sizeof(int *));
+        cand.no--;
+    }
+
+    if (iErr == 0) {
+        // copy the paths without the virtual node
+        for (total = 0, p = 0; p < found.no; p++)
+            total += found.path[p][0] - 1;
+        paths->start = (int *)malloc((found.no + 1) * sizeof(int));
+        paths->node = (int *)malloc((total + 1) * sizeof(int));
+        if (paths->start == NULL || paths->node == NULL) {
+            iErr = -1;
+        } else {
+            paths->pathno = found.no;
+            paths->start[0] = 0;
+            for (p = 0; p < found.no; p++) {
+                memcpy(paths->node + paths->start[p], found.path[p] + 2, (found.path[p][0] - 1) * sizeof(int));
+                paths->start[p + 1] = paths->start[p] + found.path[p][0] - 1;
+            }
+        }
+    }
+
+    if (iErr != 0) {
+        printf("\nMemory allocation error\n");
+        kpath_free(paths);
+    }
+
+    free(hop);
+    listfree(&found);
+    listfree(&cand);
+    free(ctx.seen);
+    free(ctx.blocked);
+    free(ctx.pred);
+    free(ctx.queue);
+
+    return iErr;
+}
+
+void kpath_free(kpath_t *paths)
+{
+    free(paths->start);
+    free(paths->node);
+    memset(paths, 0, sizeof(kpath_t));
+}
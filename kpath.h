@@ -0,0 +1,28 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _KPATH_H
+#define _KPATH_H
+
+#include "symgraph.h"
+
+typedef struct kpath kpath_t;
+
+// Up to k shortest loopless paths of a symgraph from any source to any target,
+// by increasing length (Yen's algorithm over breadth first searches).
+// Path p is node[start[p] .. start[p + 1] - 1], from a source to a target.
+struct kpath {
+    int pathno;
+    int *start;
+    int *node;
+};
+
+int kpath_find(kpath_t *paths, symgraph_t *graph, const char *keep, const int *src, int srcno,
+    const char *target, int forward, int k);
+void kpath_free(kpath_t *paths);
+
+#endif //  _KPATH_H
@@ -0,0 +1,172 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "modgraph.h"
+#include "slib.h"
+#include "ttreeparam.h"
+
+typedef struct modkey {
+    const char *name; // module name, not terminated
+    int len;
+    int node;
+} modkey_t;
+
+static int cmpkey(const void *a, const void *b)
+{
+    const modkey_t *l = (const modkey_t *)a;
+    const modkey_t *r = (const modkey_t *)b;
+    int c = memcmp(l->name, r->name, l->len < r->len ? l->len : r->len);
+
+    if (c == 0)
+        c = l->len - r->len;
+    if (c == 0)
+        c = l->node - r->node;
+
+    return c;
+}
+
+// module of a function: the directory of its file cut to depth components
+static void modname(modkey_t *key, const char *filename, int depth)
+{
+    const char *p;
+    int n = 0;
+
+    if (filename == NULL) {
+        key->name = TT_LIBRARY;
+        key->len = strlen(TT_LIBRARY);
+        return;
+    }
+
+    while (filename[0] == '.' && (filename[1] == '/' || filename[1] == '\\'))
+        filename += 2;
+
+    key->name = filename;
+    key->len = 0;
+    // a leading separator belongs to the first component
+    for (p = filename + 1; *p && n < depth; p++)
+        if ((*p == '/' || *p == '\\') && p[-1] != '/' && p[-1] != '\\') {
+            key->len = p - filename;
+            n++;
+        }
+
+    if (key->len == 0) {
+        // file in the current directory
+        key->name = ".";
+        key->len = 1;
+    }
+}
+
+// Build the module graph of the kept nodes in one pass over their calls: the
+// callees of all the functions of a module are merged with a stamp per module.
+int modgraph_build(modgraph_t *mgraph, symgraph_t *graph, const char *keep, int depth)
+{
+    modkey_t *keys;
+    int *stamp, *slot;
+    int i, j, k, m, b, keyno = 0, tono = 0;
+    int iErr = 0;
+
+    memset(mgraph, 0, sizeof(modgraph_t));
+
+    keys = (modkey_t *)malloc((graph->nodeno + 1) * sizeof(modkey_t));
+    mgraph->mod = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    if (keys == NULL || mgraph->mod == NULL) {
+        printf("\nMemory allocation error\n");
+        free(keys);
+        modgraph_free(mgraph);
+        return -1;
+    }
+
+    for (i = 0; i < graph->nodeno; i++) {
+        mgraph->mod[i] = -1;
+        if (keep == NULL || keep[i]) {
+            modname(&keys[keyno], graph->nodes[i]->filename, depth);
+            keys[keyno++].node = i;
+        }
+    }
+    qsort(keys, keyno, sizeof(modkey_t), cmpkey);
+
+    for (j = 0; j < keyno; j++)
+        if (j == 0 || keys[j].len != keys[j - 1].len || memcmp(keys[j].name, keys[j - 1].name, keys[j].len) != 0)
+            mgraph->modno++;
+
+    mgraph->name = (char **)calloc(mgraph->modno + 1, sizeof(char *));
+    mgraph->funno = (int *)calloc(mgraph->modno + 1, sizeof(int));
+    mgraph->inner = (int *)calloc(mgraph->modno + 1, sizeof(int));
+    mgraph->start = (int *)malloc((mgraph->modno + 1) * sizeof(int));
+    mgraph->to = (int *)malloc((graph->childstart[graph->nodeno] + 1) * sizeof(int));
+    mgraph->count = (int *)malloc((graph->childstart[graph->nodeno] + 1) * sizeof(int));
+    stamp = (int *)malloc((mgraph->modno + 1) * sizeof(int));
+    slot = (int *)malloc((mgraph->modno + 1) * sizeof(int));
+    if (mgraph->name == NULL || mgraph->funno == NULL || mgraph->inner == NULL || mgraph->start == NULL
+        || mgraph->to == NULL || mgraph->count == NULL || stamp == NULL || slot == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
+
+    // members of a module are consecutive keys
+    for (j = 0, m = -1; iErr == 0 && j < keyno; j++) {
+        if (j == 0 || keys[j].len != keys[j - 1].len || memcmp(keys[j].name, keys[j - 1].name, keys[j].len) != 0)
+            iErr = slibcpy(&mgraph->name[++m], keys[j].name, keys[j].len, -1);
+        mgraph->mod[keys[j].node] = m;
+        mgraph->funno[m]++;
+    }
+
+    for (m = 0; iErr == 0 && m < mgraph->modno; m++)
+        stamp[m] = -1;
+    for (j = 0, m = -1; iErr == 0 && j < keyno; j++) {
+        i = keys[j].node;
+        if (mgraph->mod[i] != m) {
+            m = mgraph->mod[i];
+            mgraph->start[m] = tono;
+        }
+        for (k = graph->childstart[i]; k < graph->childstart[i + 1]; k++) {
+            b = mgraph->mod[graph->child[k]];
+            if (b < 0)
+                continue;
+            if (b == m) {
+                mgraph->inner[m]++;
+            } else if (stamp[b] != m) {
+                stamp[b] = m;
+                slot[b] = tono;
+                mgraph->to[tono] = b;
+                mgraph->count[tono++] = 1;
+            } else {
+                mgraph->count[slot[b]]++;
+            }
+        }
+    }
+    if (iErr == 0)
+        mgraph->start[mgraph->modno] = tono;
+
+    free(keys);
+    free(stamp);
+    free(slot);
+    if (iErr != 0)
+        modgraph_free(mgraph);
+
+    return iErr;
+}
+
+void modgraph_free(modgraph_t *mgraph)
+{
+    int m;
+
+    for (m = 0; mgraph->name && m < mgraph->modno; m++)
+        free(mgraph->name[m]);
+    free(mgraph->name);
+    free(mgraph->funno);
+    free(mgraph->inner);
+    free(mgraph->mod);
+    free(mgraph->start);
+    free(mgraph->to);
+    free(mgraph->count);
+    memset(mgraph, 0, sizeof(modgraph_t));
+}
@@ -0,0 +1,33 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _MOD_GRAPH_H
+#define _MOD_GRAPH_H
+
+#include "symgraph.h"
+
+typedef struct modgraph modgraph_t;
+
+// Call graph between modules, a module being the functions defined under the
+// same directory cut to a number of path components (or the library functions).
+// Modules are sorted by name. Module m calls module to[k], for k in
+// start[m] .. start[m + 1] - 1, through count[k] distinct function calls.
+struct modgraph {
+    int modno;    // number of modules
+    char **name;  // module names
+    int *funno;   // functions of each module
+    int *inner;   // calls between functions of the same module
+    int *mod;     // module of each symgraph node, -1 if not kept
+    int *start;
+    int *to;
+    int *count;
+};
+
+int modgraph_build(modgraph_t *mgraph, symgraph_t *graph, const char *keep, int depth);
+void modgraph_free(modgraph_t *mgraph);
+
+#endif //  _MOD_GRAPH_H
@@ -0,0 +1,509 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#else
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#ifndef TT_NOTHREADS
+#include <pthread.h>
+#endif // TT_NOTHREADS
+
+#include "outbuf.h"
+
+// compressors, chosen by the suffix of the output file name
+typedef struct outzip_st {
+    const char *suffix;
+    const char *argv[4]; // command compressing its input to its output
+} outzip_t;
+
+static const outzip_t outzips[] = {
+    { ".gz", { "gzip", "-c", NULL } },
+    { ".zst", { "zstd", "-q", "-c", NULL } }
+};
+
+#define OUTZIPNO ((int)(sizeof(outzips) / sizeof(outzips[0])))
+
+#if !defined(_WIN32) && !defined(TT_NOTHREADS)
+// The pages (-g) are written on several threads, each maybe starting its own
+// compressor: one at a time, so that no compressor is forked while another
+// thread has a pipe or file not yet marked close-on-exec. A compressor keeping
+// the pipe of another one open would never see the end of its input.
+static pthread_mutex_t outbuf_spawnlock = PTHREAD_MUTEX_INITIALIZER;
+#endif // !_WIN32 && !TT_NOTHREADS
+
+#ifndef TT_NOTHREADS
+
+// The writer thread writes a full buffer to the compressor while the other one
+// is being filled, so that the output is made while the compressor works
+// instead of waiting for it at every write.
+struct outbuf_writer_st {
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond; // a buffer was handed over, or written
+    FILE *file;
+    char *data;          // buffer to write, NULL when the writer is idle
+    int size;
+    char *spare;         // buffer written, to be filled again
+    int stop;
+    int err;
+};
+
+static void *outbuf_write(void *arg)
+{
+    outbuf_writer_t *w = (outbuf_writer_t *)arg;
+    char *data;
+    int size, ok;
+
+    pthread_mutex_lock(&w->lock);
+    for (;;) {
+        while (w->data == NULL && !w->stop)
+            pthread_cond_wait(&w->cond, &w->lock);
+        if (w->data == NULL)
+            break;
+
+        data = w->data;
+        size = w->size;
+        pthread_mutex_unlock(&w->lock);
+        ok = fwrite(data, 1, size, w->file) == (size_t)size;
+        pthread_mutex_lock(&w->lock);
+
+        if (!ok)
+            w->err = 1;
+        w->spare = data;
+        w->data = NULL;
+        pthread_cond_broadcast(&w->cond);
+    }
+    pthread_mutex_unlock(&w->lock);
+
+    return NULL;
+}
+
+// start the writer thread; without it the buffers are written as they fill
+static void outbuf_startwriter(outbuf_t *pbuf)
+{
+    outbuf_writer_t *w;
+
+    w = (outbuf_writer_t *)calloc(1, sizeof(outbuf_writer_t));
+    if (w == NULL)
+        return;
+    w->file = pbuf->file;
+    w->spare = (char *)malloc(OUTBUFSIZE);
+    if (w->spare == NULL) {
+        free(w);
+        return;
+    }
+    pthread_mutex_init(&w->lock, NULL);
+    pthread_cond_init(&w->cond, NULL);
+    if (pthread_create(&w->thread, NULL, outbuf_write, w) != 0) {
+        pthread_mutex_destroy(&w->lock);
+        pthread_cond_destroy(&w->cond);
+        free(w->spare);
+        free(w);
+        return;
+    }
+    pbuf->writer = w;
+}
+
+// wait until the writer thread has written everything handed over to it
+static void outbuf_idle(outbuf_t *pbuf)
+{
+    outbuf_writer_t *w = pbuf->writer;
+
+    pthread_mutex_lock(&w->lock);
+    while (w->data != NULL)
+        pthread_cond_wait(&w->cond, &w->lock);
+    if (w->err)
+        pbuf->err = 1;
+    pthread_mutex_unlock(&w->lock);
+}
+
+// hand the buffer over to the writer thread and take the spare one
+static void outbuf_handover(outbuf_t *pbuf)
+{
+    outbuf_writer_t *w = pbuf->writer;
+
+    pthread_mutex_lock(&w->lock);
+    while (w->data != NULL)
+        pthread_cond_wait(&w->cond, &w->lock);
+    if (w->err)
+        pbuf->err = 1;
+    w->data = pbuf->data;
+    w->size = pbuf->size;
+    pbuf->data = w->spare;
+    w->spare = NULL;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+}
+
+// let the writer thread finish
+static void outbuf_stopwriter(outbuf_t *pbuf)
+{
+    outbuf_writer_t *w = pbuf->writer;
+
+    pthread_mutex_lock(&w->lock);
+    w->stop = 1;
+    pthread_cond_broadcast(&w->cond);
+    pthread_mutex_unlock(&w->lock);
+    pthread_join(w->thread, NULL);
+
+    if (w->err)
+        pbuf->err = 1;
+    pthread_mutex_destroy(&w->lock);
+    pthread_cond_destroy(&w->cond);
+    free(w->spare);
+    free(w);
+    pbuf->writer = NULL;
+}
+
+#endif // TT_NOTHREADS
+
+// compressor for a file name, NULL if the name has no compressed suffix
+static const outzip_t *outzip(const char *filename)
+{
+    size_t n = strlen(filename), len;
+    int i;
+
+    for (i = 0; i < OUTZIPNO; i++) {
+        len = strlen(outzips[i].suffix);
+        if (n > len && strcmp(filename + n - len, outzips[i].suffix) == 0)
+            return &outzips[i];
+    }
+
+    return NULL;
+}
+
+// length of the suffix asking for compression at the end of a file name, 0 if none
+int outbuf_zipsuffix(const char *filename)
+{
+    const outzip_t *zip = outzip(filename);
+
+    return zip ? (int)strlen(zip->suffix) : 0;
+}
+
+// name of a file made from another one with a tag before the extension, and
+// before the suffix of a compressed file (calls.csv.gz and ".nodes" make
+// calls.nodes.csv.gz); to be freed, NULL if out of memory
+char *outbuf_name(const char *filename, const char *tag)
+{
+    const char *base, *end, *ext, *s;
+    char *name;
+
+    name = (char *)malloc(strlen(filename) + strlen(tag) + 1);
+    if (name == NULL)
+        return NULL;
+    base = filename;
+    for (s = filename; *s; s++)
+        if (*s == '/' || *s == '\\')
+            base = s + 1;
+    end = base + strlen(base) - outbuf_zipsuffix(base);
+    for (ext = end - 1; ext > base && *ext != '.'; ext--)
+        ;
+    if (ext <= base)
+        ext = end; // no extension, or a dot file
+    memcpy(name, filename, ext - filename);
+    strcpy(name + (ext - filename), tag);
+    strcat(name, ext);
+
+    return name;
+}
+
+// open a plain output file, not left open in the compressors started meanwhile
+static FILE *outbuf_fopen(const char *filename)
+{
+#ifdef _WIN32
+    return fopen(filename, "w");
+#else
+    FILE *file;
+    int fd;
+
+    fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0)
+        return NULL;
+    file = fdopen(fd, "w");
+    if (file == NULL)
+        close(fd);
+
+    return file;
+#endif // _WIN32
+}
+
+// start the compressor writing the file and return the pipe to it
+static FILE *outbuf_spawn(outbuf_t *pbuf, const char *filename, const outzip_t *zip)
+{
+#ifdef _WIN32
+    FILE *pipew;
+    char *cmd;
+
+    cmd = (char *)malloc(strlen(filename) + 32);
+    if (cmd == NULL)
+        return NULL;
+    sprintf(cmd, "%s %s > \"%s\"", zip->argv[0], zip->argv[1], filename);
+    pipew = popen(cmd, "wb");
+    free(cmd);
+
+    return pipew;
+#else
+    FILE *pipew;
+    int fd[2], out;
+    pid_t pid = -1;
+
+#ifndef TT_NOTHREADS
+    pthread_mutex_lock(&outbuf_spawnlock);
+#endif // TT_NOTHREADS
+    // other compressors started later must not keep the file or the pipe open
+    out = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (out >= 0 && pipe(fd) == 0) {
+        fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+
+        pid = fork();
+        if (pid == 0) {
+            dup2(fd[0], STDIN_FILENO);
+            dup2(out, STDOUT_FILENO);
+            execvp(zip->argv[0], (char *const *)zip->argv);
+            _exit(127);
+        }
+        close(fd[0]);
+        if (pid < 0)
+            close(fd[1]);
+    }
+    if (out >= 0)
+        close(out);
+#ifndef TT_NOTHREADS
+    pthread_mutex_unlock(&outbuf_spawnlock);
+#endif // TT_NOTHREADS
+    if (pid < 0)
+        return NULL;
+
+    pipew = fdopen(fd[1], "wb");
+    if (pipew == NULL) {
+        close(fd[1]);
+        waitpid(pid, NULL, 0);
+        return NULL;
+    }
+    // a compressor that failed makes the writes fail instead of killing us
+    signal(SIGPIPE, SIG_IGN);
+    pbuf->pid = pid;
+
+    return pipew;
+#endif // _WIN32
+}
+
+// close the pipe and wait for the compressor: != 0 if it failed
+static int outbuf_unspawn(outbuf_t *pbuf)
+{
+#ifdef _WIN32
+    return pclose(pbuf->file) != 0;
+#else
+    int status, iErr = 0;
+
+    if (fclose(pbuf->file) != 0)
+        iErr = -1;
+    if (waitpid((pid_t)pbuf->pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        iErr = -1;
+
+    return iErr;
+#endif // _WIN32
+}
+
+// open the output file, through a compressor if its name asks for it; pbuf is zeroed first
+int outbuf_open(outbuf_t *pbuf, const char *filename)
+{
+    const outzip_t *zip = outzip(filename);
+
+    memset(pbuf, 0, sizeof(outbuf_t));
+    pbuf->data = (char *)malloc(OUTBUFSIZE);
+    if (pbuf->data == NULL) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+    pbuf->max = OUTBUFSIZE;
+
+    if (zip != NULL) {
+        pbuf->zip = zip->argv[0];
+        pbuf->file = outbuf_spawn(pbuf, filename, zip);
+    } else {
+        pbuf->file = outbuf_fopen(filename);
+    }
+    if (pbuf->file == NULL) {
+        printf("\nError while opening output file\n");
+        outbuf_free(pbuf);
+        return -1;
+    }
+    // the buffer is ours: stdio would only copy it again
+    setvbuf(pbuf->file, NULL, _IONBF, 0);
+
+#ifndef TT_NOTHREADS
+    if (zip != NULL)
+        outbuf_startwriter(pbuf);
+#endif // TT_NOTHREADS
+
+    return 0;
+}
+
+// write what is left, close the file and free the buffer
+int outbuf_close(outbuf_t *pbuf)
+{
+    int iErr = 0;
+
+    outbuf_flush(pbuf);
+#ifndef TT_NOTHREADS
+    if (pbuf->writer != NULL)
+        outbuf_stopwriter(pbuf);
+#endif // TT_NOTHREADS
+    if (pbuf->err) {
+        printf("\nError while writing output file\n");
+        iErr = -1;
+    }
+
+    if (pbuf->file != NULL && pbuf->zip != NULL) {
+        if (outbuf_unspawn(pbuf) != 0) {
+            printf("\nError while compressing output file with %s\n", pbuf->zip);
+            iErr = -1;
+        }
+    } else if (pbuf->file != NULL && fclose(pbuf->file) != 0) {
+        printf("\nError while closing output file\n");
+        iErr = -1;
+    }
+    pbuf->file = NULL;
+    outbuf_free(pbuf);
+
+    return iErr;
+}
+
+// free the buffer without writing it
+void outbuf_free(outbuf_t *pbuf)
+{
+    free(pbuf->data);
+    pbuf->data = NULL;
+    pbuf->size = pbuf->max = 0;
+}
+
+// write the buffer to the file
+void outbuf_flush(outbuf_t *pbuf)
+{
+    if (pbuf->file == NULL || pbuf->size == 0) {
+        pbuf->size = 0;
+        return;
+    }
+
+#ifndef TT_NOTHREADS
+    if (pbuf->writer != NULL) {
+        outbuf_handover(pbuf);
+        pbuf->size = 0;
+        return;
+    }
+#endif // TT_NOTHREADS
+
+    if (fwrite(pbuf->data, 1, pbuf->size, pbuf->file) != (size_t)pbuf->size)
+        pbuf->err = 1;
+    pbuf->size = 0;
+}
+
+// append n bytes: the buffer of a file is written when full, a buffer in memory grows
+void outbuf_mem(outbuf_t *pbuf, const char *s, int n)
+{
+    char *data;
+    int max;
+
+    // nothing to copy, e.g. from a buffer still unallocated
+    if (n == 0)
+        return;
+
+    if (pbuf->size + n > pbuf->max) {
+        if (pbuf->file != NULL) {
+            outbuf_flush(pbuf);
+            if (n > pbuf->max) {
+#ifndef TT_NOTHREADS
+                if (pbuf->writer != NULL)
+                    outbuf_idle(pbuf);
+#endif // TT_NOTHREADS
+                if (fwrite(s, 1, n, pbuf->file) != (size_t)n)
+                    pbuf->err = 1;
+                return;
+            }
+        } else {
+            for (max = 2 * pbuf->max + 64; max < pbuf->size + n; max *= 2)
+                ;
+            data = (char *)realloc(pbuf->data, max);
+            if (data == NULL) {
+                pbuf->err = 1;
+                return;
+            }
+            pbuf->data = data;
+            pbuf->max = max;
+        }
+    }
+    memcpy(pbuf->data + pbuf->size, s, n);
+    pbuf->size += n;
+}
+
+// append a string
+void outbuf_str(outbuf_t *pbuf, const char *s)
+{
+    outbuf_mem(pbuf, s, strlen(s));
+}
+
+// append a character
+void outbuf_char(outbuf_t *pbuf, char c)
+{
+    if (pbuf->size < pbuf->max)
+        pbuf->data[pbuf->size++] = c;
+    else
+        outbuf_mem(pbuf, &c, 1);
+}
+
+// append a number
+void outbuf_int(outbuf_t *pbuf, long n)
+{
+    char s[24];
+    unsigned long u = n < 0 ? -(unsigned long)n : (unsigned long)n;
+    int i = sizeof(s);
+
+    do {
+        s[--i] = '0' + u % 10;
+        u /= 10;
+    } while (u > 0);
+    if (n < 0)
+        s[--i] = '-';
+    outbuf_mem(pbuf, s + i, sizeof(s) - i);
+}
+
+// append a string as XML text or attribute value
+void outbuf_xml(outbuf_t *pbuf, const char *s)
+{
+    for (; *s; s++) {
+        switch (*s) {
+        case '&':
+            outbuf_str(pbuf, "&amp;");
+            break;
+        case '<':
+            outbuf_str(pbuf, "&lt;");
+            break;
+        case '>':
+            outbuf_str(pbuf, "&gt;");
+            break;
+        case '"':
+            outbuf_str(pbuf, "&quot;");
+            break;
+        default:
+            outbuf_char(pbuf, *s);
+            break;
+        }
+    }
+}
@@ -0,0 +1,45 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _OUTBUF_H
+#define _OUTBUF_H
+
+#include <stdio.h>
+
+#define OUTBUFSIZE (1 << 20) // output buffer, written with one call when full
+
+typedef struct outbuf_writer_st outbuf_writer_t;
+
+// Output put together in a large buffer by copying fragments, so that no
+// format string is parsed per node or branch and the file is written in a few
+// big unbuffered writes. A buffer without file grows in memory instead.
+// Files named *.gz or *.zst are compressed by gzip or zstd, fed through a pipe
+// by a writer thread while the next buffer is being filled.
+typedef struct outbuf_st {
+    FILE *file;              // NULL for a buffer in memory
+    char *data;
+    int size;                // bytes in the buffer
+    int max;                 // allocated bytes
+    int err;                 // != 0 if a write or an allocation failed
+    const char *zip;         // compressor, NULL if none
+    long pid;                // process of the compressor
+    outbuf_writer_t *writer; // thread writing the full buffers, NULL if none
+} outbuf_t;
+
+int outbuf_zipsuffix(const char *filename);
+char *outbuf_name(const char *filename, const char *tag);
+int outbuf_open(outbuf_t *pbuf, const char *filename);
+int outbuf_close(outbuf_t *pbuf);
+void outbuf_free(outbuf_t *pbuf);
+void outbuf_flush(outbuf_t *pbuf);
+void outbuf_mem(outbuf_t *pbuf, const char *s, int n);
+void outbuf_str(outbuf_t *pbuf, const char *s);
+void outbuf_char(outbuf_t *pbuf, char c);
+void outbuf_int(outbuf_t *pbuf, long n);
+void outbuf_xml(outbuf_t *pbuf, const char *s);
+
+#endif //  _OUTBUF_H
@@ -0,0 +1,610 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "outbuf.h"
+#include "outdata.h"
+
+// Graph exports for tools other than graphviz (NDJSON, CSV and GraphML), and
+// the counts of the nodes and branches as one JSON object (stats). Every node
+// and branch is written as soon as it is printed, so the memory used does not
+// depend on the size of the graph. A function is written once, when it is
+// printed or first calls or is called; the functions with the same name
+// defined in different files are one node, as in the graphviz output.
+
+#define DATNAMESIZE 24 // room for the synthetic name of a component
+
+// one node or branch, as handed to the writer of a format
+typedef struct datrec_st {
+    char *source;       // node name, or caller of a branch
+    char *target;       // callee of a branch, NULL for a node
+    char *file;         // file of the function or of the call, NULL if unknown
+    const char *tag;    // appended to the node, or to the callee of a branch, NULL if none:
+                        // " hidden" for the summary node behind a function (-n option)
+    long weight;        // functions of a node, calls or samples of a branch
+    int highlight;      // 0 = plain, 1 = highlighted, > 1 = heat of a profile (-P option)
+    symgraph_t *pgraph; // graph and component of a node of the condensed graph (-S option)
+    scc_t *pscc;
+    int c;
+} datrec_t;
+
+typedef struct datfmt_st {
+    int (*begin)(treeparam_t *pparam);
+    void (*node)(datrec_t *prec);
+    void (*branch)(datrec_t *prec);
+    void (*end)(void);
+} datfmt_t;
+
+// state of one output; more than one can be written at once (-o option)
+typedef struct datctx_st {
+    outbuf_t out;          // output file: everything, only the branches for CSV
+    outbuf_t csvnodes;     // node list of the CSV output
+    const datfmt_t *fmt;   // format of the output
+    int bit;               // bit of the output in outlisted
+    long nodeno;           // counts of the stats output
+    long branchno;
+    long funno;
+    long weight;
+    long hlnodeno;
+    long hlbranchno;
+} datctx_t;
+
+static datctx_t datctx[TT_MAXOUTS];
+static datctx_t *dat = &datctx[0];     // output being written
+static symtree_t *dattree = NULL;      // functions, to list the ones with the same name at once
+
+// print a string as JSON, followed by tag if not NULL, null if missing
+static void outjsonstr_dat(outbuf_t *pbuf, const char *s, const char *tag)
+{
+    static const char hex[] = "0123456789abcdef";
+
+    if (s == NULL) {
+        outbuf_str(pbuf, "null");
+        return;
+    }
+
+    outbuf_char(pbuf, '"');
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            outbuf_char(pbuf, '\\');
+            outbuf_char(pbuf, *s);
+        } else if ((unsigned char)*s < 0x20) {
+            outbuf_str(pbuf, "\\u00");
+            outbuf_char(pbuf, hex[(unsigned char)*s >> 4]);
+            outbuf_char(pbuf, hex[*s & 0xf]);
+        } else {
+            outbuf_char(pbuf, *s);
+        }
+    }
+    if (tag != NULL)
+        outbuf_str(pbuf, tag);
+    outbuf_char(pbuf, '"');
+}
+
+// print a string inside CSV quotes, doubling the quotes
+static void outcsvtext_dat(outbuf_t *pbuf, const char *s)
+{
+    for (; *s; s++) {
+        if (*s == '"')
+            outbuf_char(pbuf, '"');
+        outbuf_char(pbuf, *s);
+    }
+}
+
+// print a CSV field, followed by tag if not NULL (plain text, never quoted),
+// quoted only if needed; empty if missing
+static void outcsvfield_dat(outbuf_t *pbuf, const char *s, const char *tag)
+{
+    if (s == NULL)
+        return;
+
+    if (strpbrk(s, ",\"\r\n") == NULL) {
+        outbuf_str(pbuf, s);
+        if (tag != NULL)
+            outbuf_str(pbuf, tag);
+    } else {
+        outbuf_char(pbuf, '"');
+        outcsvtext_dat(pbuf, s);
+        if (tag != NULL)
+            outbuf_str(pbuf, tag);
+        outbuf_char(pbuf, '"');
+    }
+}
+
+// number of members of a component node, 0 if the node is not a component
+static int outmemberno_dat(datrec_t *prec)
+{
+    if (prec->pscc == NULL)
+        return 0;
+
+    return prec->pscc->memberstart[prec->c + 1] - prec->pscc->memberstart[prec->c];
+}
+
+// name of member i of a component node
+static char *outmember_dat(datrec_t *prec, int i)
+{
+    return prec->pgraph->nodes[prec->pscc->member[prec->pscc->memberstart[prec->c] + i]]->funname;
+}
+
+// NDJSON: one object per line, nodes and branches told apart by their type
+static int outbegin_json(treeparam_t *pparam)
+{
+    return 0;
+}
+
+static void outnode_json(datrec_t *prec)
+{
+    int i, memberno = outmemberno_dat(prec);
+
+    outbuf_str(&dat->out, "{\"type\":\"node\",\"id\":");
+    outjsonstr_dat(&dat->out, prec->source, prec->tag);
+    outbuf_str(&dat->out, ",\"file\":");
+    outjsonstr_dat(&dat->out, prec->file, NULL);
+    outbuf_str(&dat->out, ",\"functions\":");
+    outbuf_int(&dat->out, prec->weight);
+    outbuf_str(&dat->out, ",\"highlight\":");
+    outbuf_int(&dat->out, prec->highlight);
+    if (memberno > 1) {
+        outbuf_str(&dat->out, ",\"members\":[");
+        for (i = 0; i < memberno; i++) {
+            if (i > 0)
+                outbuf_char(&dat->out, ',');
+            outjsonstr_dat(&dat->out, outmember_dat(prec, i), NULL);
+        }
+        outbuf_char(&dat->out, ']');
+    }
+    outbuf_str(&dat->out, "}\n");
+}
+
+static void outbranch_json(datrec_t *prec)
+{
+    outbuf_str(&dat->out, "{\"type\":\"edge\",\"source\":");
+    outjsonstr_dat(&dat->out, prec->source, NULL);
+    outbuf_str(&dat->out, ",\"target\":");
+    outjsonstr_dat(&dat->out, prec->target, prec->tag);
+    outbuf_str(&dat->out, ",\"file\":");
+    outjsonstr_dat(&dat->out, prec->file, NULL);
+    outbuf_str(&dat->out, ",\"weight\":");
+    outbuf_int(&dat->out, prec->weight);
+    outbuf_str(&dat->out, ",\"highlight\":");
+    outbuf_int(&dat->out, prec->highlight);
+    outbuf_str(&dat->out, "}\n");
+}
+
+static void outend_json(void)
+{
+}
+
+// CSV: the branches go to the output file, the nodes to a second file named
+// after it, with ".nodes" before the extension (calls.csv.gz: calls.nodes.csv.gz)
+static int outbegin_csv(treeparam_t *pparam)
+{
+    int iErr;
+    char *name;
+
+    name = outbuf_name(pparam->outfile, ".nodes");
+    if (name == NULL) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+
+    iErr = outbuf_open(&dat->csvnodes, name);
+    free(name);
+    if (iErr == 0) {
+        outbuf_str(&dat->csvnodes, "id,file,functions,highlight,members\n");
+        outbuf_str(&dat->out, "source,target,file,weight,highlight\n");
+    }
+
+    return iErr;
+}
+
+static void outnode_csv(datrec_t *prec)
+{
+    int i, memberno = outmemberno_dat(prec);
+
+    outcsvfield_dat(&dat->csvnodes, prec->source, prec->tag);
+    outbuf_char(&dat->csvnodes, ',');
+    outcsvfield_dat(&dat->csvnodes, prec->file, NULL);
+    outbuf_char(&dat->csvnodes, ',');
+    outbuf_int(&dat->csvnodes, prec->weight);
+    outbuf_char(&dat->csvnodes, ',');
+    outbuf_int(&dat->csvnodes, prec->highlight);
+    outbuf_char(&dat->csvnodes, ',');
+    if (memberno > 1) {
+        // members separated by ';', the array delimiter of most bulk loaders
+        outbuf_char(&dat->csvnodes, '"');
+        for (i = 0; i < memberno; i++) {
+            if (i > 0)
+                outbuf_char(&dat->csvnodes, ';');
+            outcsvtext_dat(&dat->csvnodes, outmember_dat(prec, i));
+        }
+        outbuf_char(&dat->csvnodes, '"');
+    }
+    outbuf_char(&dat->csvnodes, '\n');
+}
+
+static void outbranch_csv(datrec_t *prec)
+{
+    outcsvfield_dat(&dat->out, prec->source, NULL);
+    outbuf_char(&dat->out, ',');
+    outcsvfield_dat(&dat->out, prec->target, prec->tag);
+    outbuf_char(&dat->out, ',');
+    outcsvfield_dat(&dat->out, prec->file, NULL);
+    outbuf_char(&dat->out, ',');
+    outbuf_int(&dat->out, prec->weight);
+    outbuf_char(&dat->out, ',');
+    outbuf_int(&dat->out, prec->highlight);
+    outbuf_char(&dat->out, '\n');
+}
+
+static void outend_csv(void)
+{
+    if (outbuf_close(&dat->csvnodes) != 0)
+        dat->out.err = 1;
+}
+
+// GraphML: attributes equal to their default are left out
+static int outbegin_gml(treeparam_t *pparam)
+{
+    outbuf_str(&dat->out,
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<graphml xmlns=\"http://graphml.graphdrawing.org/xmlns\">\n"
+        "  <key id=\"file\" for=\"all\" attr.name=\"file\" attr.type=\"string\"/>\n"
+        "  <key id=\"functions\" for=\"node\" attr.name=\"functions\" attr.type=\"int\"><default>1</default></key>\n"
+        "  <key id=\"members\" for=\"node\" attr.name=\"members\" attr.type=\"string\"/>\n"
+        "  <key id=\"weight\" for=\"edge\" attr.name=\"weight\" attr.type=\"long\"><default>1</default></key>\n"
+        "  <key id=\"highlight\" for=\"all\" attr.name=\"highlight\" attr.type=\"int\"><default>0</default></key>\n"
+        "  <graph id=\"G\" edgedefault=\"directed\">\n");
+
+    return 0;
+}
+
+// print the attributes of a node or branch, and close it
+static void outdata_gml(datrec_t *prec, const char *weightkey, const char *end)
+{
+    int i, memberno = outmemberno_dat(prec);
+
+    if (prec->file == NULL && prec->weight == 1 && prec->highlight == 0 && memberno <= 1) {
+        outbuf_str(&dat->out, "/>\n");
+        return;
+    }
+
+    outbuf_char(&dat->out, '>');
+    if (prec->file != NULL) {
+        outbuf_str(&dat->out, "<data key=\"file\">");
+        outbuf_xml(&dat->out, prec->file);
+        outbuf_str(&dat->out, "</data>");
+    }
+    if (prec->weight != 1) {
+        outbuf_str(&dat->out, "<data key=\"");
+        outbuf_str(&dat->out, weightkey);
+        outbuf_str(&dat->out, "\">");
+        outbuf_int(&dat->out, prec->weight);
+        outbuf_str(&dat->out, "</data>");
+    }
+    if (prec->highlight != 0) {
+        outbuf_str(&dat->out, "<data key=\"highlight\">");
+        outbuf_int(&dat->out, prec->highlight);
+        outbuf_str(&dat->out, "</data>");
+    }
+    if (memberno > 1) {
+        outbuf_str(&dat->out, "<data key=\"members\">");
+        for (i = 0; i < memberno; i++) {
+            if (i > 0)
+                outbuf_char(&dat->out, ';');
+            outbuf_xml(&dat->out, outmember_dat(prec, i));
+        }
+        outbuf_str(&dat->out, "</data>");
+    }
+    outbuf_str(&dat->out, end);
+}
+
+static void outnode_gml(datrec_t *prec)
+{
+    outbuf_str(&dat->out, "    <node id=\"");
+    outbuf_xml(&dat->out, prec->source);
+    if (prec->tag != NULL)
+        outbuf_str(&dat->out, prec->tag);
+    outbuf_char(&dat->out, '"');
+    outdata_gml(prec, "functions", "</node>\n");
+}
+
+static void outbranch_gml(datrec_t *prec)
+{
+    outbuf_str(&dat->out, "    <edge source=\"");
+    outbuf_xml(&dat->out, prec->source);
+    outbuf_str(&dat->out, "\" target=\"");
+    outbuf_xml(&dat->out, prec->target);
+    if (prec->tag != NULL)
+        outbuf_str(&dat->out, prec->tag);
+    outbuf_char(&dat->out, '"');
+    outdata_gml(prec, "weight", "</edge>\n");
+}
+
+static void outend_gml(void)
+{
+    outbuf_str(&dat->out, "  </graph>\n</graphml>\n");
+}
+
+// stats: only the counts of what would be written, as one JSON object
+static int outbegin_stats(treeparam_t *pparam)
+{
+    dat->nodeno = dat->branchno = dat->funno = dat->weight = 0;
+    dat->hlnodeno = dat->hlbranchno = 0;
+
+    return 0;
+}
+
+static void outnode_stats(datrec_t *prec)
+{
+    dat->nodeno++;
+    dat->funno += prec->weight;
+    if (prec->highlight != 0)
+        dat->hlnodeno++;
+}
+
+static void outbranch_stats(datrec_t *prec)
+{
+    dat->branchno++;
+    dat->weight += prec->weight;
+    if (prec->highlight != 0)
+        dat->hlbranchno++;
+}
+
+static void outend_stats(void)
+{
+    outbuf_str(&dat->out, "{\"nodes\":");
+    outbuf_int(&dat->out, dat->nodeno);
+    outbuf_str(&dat->out, ",\"edges\":");
+    outbuf_int(&dat->out, dat->branchno);
+    outbuf_str(&dat->out, ",\"functions\":");
+    outbuf_int(&dat->out, dat->funno);
+    outbuf_str(&dat->out, ",\"weight\":");
+    outbuf_int(&dat->out, dat->weight);
+    outbuf_str(&dat->out, ",\"highlighted_nodes\":");
+    outbuf_int(&dat->out, dat->hlnodeno);
+    outbuf_str(&dat->out, ",\"highlighted_edges\":");
+    outbuf_int(&dat->out, dat->hlbranchno);
+    outbuf_str(&dat->out, "}\n");
+}
+
+// formats, in the order of treeouttype_t after TREEOUT_GRAPHVIZ
+static const datfmt_t datfmts[] = {
+    { outbegin_json, outnode_json, outbranch_json, outend_json },    // TREEOUT_NDJSON
+    { outbegin_csv, outnode_csv, outbranch_csv, outend_csv },        // TREEOUT_CSV
+    { outbegin_gml, outnode_gml, outbranch_gml, outend_gml },        // TREEOUT_GRAPHML
+    { outbegin_stats, outnode_stats, outbranch_stats, outend_stats } // TREEOUT_STATS
+};
+
+// write to the output in slot (-o option) from now on
+void outselect_dat(int slot)
+{
+    dat = &datctx[slot];
+    dat->bit = 1 << slot;
+}
+
+// start output
+int outopen_dat(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr;
+    symtree_node_t *pnode;
+
+    dat->fmt = &datfmts[pparam->outtype - TREEOUT_NDJSON];
+    dattree = ptree;
+    for (pnode = symtree_first(ptree); pnode != NULL; pnode = symtree_next(pnode))
+        pnode->outlisted &= ~dat->bit;
+
+    iErr = outbuf_open(&dat->out, pparam->outfile);
+    if (iErr == 0) {
+        iErr = dat->fmt->begin(pparam);
+        if (iErr != 0)
+            outbuf_close(&dat->out);
+    }
+
+    return iErr;
+}
+
+// end output
+int outclose_dat(symtree_t *ptree, treeparam_t *pparam)
+{
+    dat->fmt->end();
+    dattree = NULL;
+
+    return outbuf_close(&dat->out);
+}
+
+// write a function as a node, unless already written
+static void outlist_dat(symtree_node_t *pnode)
+{
+    datrec_t rec;
+    symtree_node_t *pname;
+
+    if (pnode->outlisted & dat->bit)
+        return;
+
+    // the functions with the same name are next to each other in the tree
+    for (pname = symtree_find_first(dattree, pnode->funname); pname != NULL && strcmp(pname->funname, pnode->funname) == 0; pname = symtree_next(pname))
+        pname->outlisted |= dat->bit;
+    pnode->outlisted |= dat->bit;
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = pnode->funname;
+    rec.file = pnode->filename;
+    rec.weight = 1;
+    rec.highlight = pnode->icolor;
+    dat->fmt->node(&rec);
+}
+
+// print one node
+int outnode_dat(symtree_node_t *pnode, treeparam_t *pparam)
+{
+    if (pnode != NULL && pnode->funname != NULL)
+        outlist_dat(pnode);
+
+    return 0;
+}
+
+// print one branch, with the file where the call is
+int outbranch_dat(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int revert_direction)
+{
+    datrec_t rec;
+    symtree_node_t *parent, *child;
+
+    if (revert_direction) {
+        parent = callee;
+        child = caller;
+    } else {
+        parent = caller;
+        child = callee;
+    }
+    outlist_dat(parent);
+    outlist_dat(child);
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = parent->funname;
+    rec.target = child->funname;
+    rec.file = parent->filename;
+    rec.weight = 1;
+    rec.highlight = parent->icolor > 0;
+    dat->fmt->branch(&rec);
+
+    return 0;
+}
+
+// print one branch weighted by its profile samples
+int outhotbranch_dat(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam)
+{
+    datrec_t rec;
+
+    outlist_dat(caller);
+    outlist_dat(callee);
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = caller->funname;
+    rec.target = callee->funname;
+    rec.file = caller->filename;
+    rec.weight = samples;
+    rec.highlight = heat;
+    dat->fmt->branch(&rec);
+
+    return 0;
+}
+
+// print the summary node of the functions left out behind a function (-n
+// option), named after it with " hidden", and the branch to it
+int outstub_dat(symtree_node_t *pnode, int hidden, treeparam_t *pparam)
+{
+    datrec_t rec;
+
+    outlist_dat(pnode);
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = pnode->funname;
+    rec.tag = " hidden";
+    rec.weight = hidden;
+    dat->fmt->node(&rec);
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = pnode->funname;
+    rec.target = pnode->funname;
+    rec.tag = " hidden";
+    rec.file = pnode->filename;
+    rec.weight = 1;
+    dat->fmt->branch(&rec);
+
+    return 0;
+}
+
+// print one module of the aggregated graph with its number of functions
+int outmodnode_dat(char *name, int funno, treeparam_t *pparam)
+{
+    datrec_t rec;
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = name;
+    rec.weight = funno;
+    dat->fmt->node(&rec);
+
+    return 0;
+}
+
+// print one branch of the aggregated graph with the number of calls it stands for
+int outmodbranch_dat(char *caller, char *callee, int count, treeparam_t *pparam)
+{
+    datrec_t rec;
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = caller;
+    rec.target = callee;
+    rec.weight = count;
+    dat->fmt->branch(&rec);
+
+    return 0;
+}
+
+// name of a strongly connected component: the function name if it has a
+// single member, a synthetic name otherwise
+static char *outsccname_dat(symgraph_t *pgraph, scc_t *pscc, int c, char *name)
+{
+    if (pscc->memberstart[c + 1] - pscc->memberstart[c] == 1)
+        return pgraph->nodes[pscc->member[pscc->memberstart[c]]]->funname;
+
+    snprintf(name, DATNAMESIZE, "scc_%d", c);
+
+    return name;
+}
+
+// print one node of the condensed graph with its members, and their file if
+// they are all defined in the same one
+int outsccnode_dat(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam)
+{
+    datrec_t rec;
+    char name[DATNAMESIZE];
+    int m, first, last;
+    symtree_node_t *pnode;
+
+    first = pscc->memberstart[c];
+    last = pscc->memberstart[c + 1];
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = outsccname_dat(pgraph, pscc, c, name);
+    rec.file = pgraph->nodes[pscc->member[first]]->filename;
+    rec.weight = last - first;
+    rec.pgraph = pgraph;
+    rec.pscc = pscc;
+    rec.c = c;
+    rec.highlight = hl;
+    for (m = first; rec.file != NULL && m < last; m++) {
+        pnode = pgraph->nodes[pscc->member[m]];
+        if (pnode->filename == NULL || strcmp(pnode->filename, rec.file) != 0)
+            rec.file = NULL;
+    }
+    dat->fmt->node(&rec);
+
+    return 0;
+}
+
+// print one branch of the condensed graph
+int outsccbranch_dat(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam)
+{
+    datrec_t rec;
+    char fromname[DATNAMESIZE], toname[DATNAMESIZE];
+
+    memset(&rec, 0, sizeof(datrec_t));
+    rec.source = outsccname_dat(pgraph, pscc, from, fromname);
+    rec.target = outsccname_dat(pgraph, pscc, to, toname);
+    rec.weight = 1;
+    rec.highlight = hl;
+    // the calling file is known only when the caller is a single function
+    if (pscc->memberstart[from + 1] - pscc->memberstart[from] == 1)
+        rec.file = pgraph->nodes[pscc->member[pscc->memberstart[from]]]->filename;
+    dat->fmt->branch(&rec);
+
+    return 0;
+}
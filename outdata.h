@@ -0,0 +1,27 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _OUTDATA_H
+#define _OUTDATA_H
+
+#include "scc.h"
+#include "symtree.h"
+#include "ttreeparam.h"
+
+void outselect_dat(int slot);
+int outopen_dat(symtree_t *ptree, treeparam_t *pparam);
+int outclose_dat(symtree_t *ptree, treeparam_t *pparam);
+int outnode_dat(symtree_node_t *pnode, treeparam_t *pparam);
+int outbranch_dat(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int reverse_direction);
+int outhotbranch_dat(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam);
+int outstub_dat(symtree_node_t *pnode, int hidden, treeparam_t *pparam);
+int outmodnode_dat(char *name, int funno, treeparam_t *pparam);
+int outmodbranch_dat(char *caller, char *callee, int count, treeparam_t *pparam);
+int outsccnode_dat(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam);
+int outsccbranch_dat(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam);
+
+#endif //  _OUTDATA_H
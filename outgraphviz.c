@@ -26,16 +26,21 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef TT_NOTHREADS
+#include <pthread.h>
+#endif // TT_NOTHREADS
+
 #ifndef _ALL_IN_ONE
 #include "defines.h"
+#include "outbuf.h"
 #include "outgraphviz.h"
+#include "parmark.h"
 #include "slib.h"
 #endif // _ALL_IN_ONE
 
-static FILE *grafile = NULL; // output file pointer
-
 #define HSTYLESNO TT_MAXSTYLES // maximum colors + styles
-#define HSTYLES1 3             // number of colors
+#define GRAHLSIZE 64           // room for the highlight attributes
+#define GRABATCH (1 << 16)     // statements formatted by each thread at once (-j option)
 
 // user will specify just a number between 0 and (TT_MAXSTYLES - 1) to choose among some colors OR styles
 char *hlstyles[HSTYLESNO] = {
@@ -47,42 +52,477 @@ char *hlstyles[HSTYLESNO] = {
     "dotted"  // 5
 };
 
+// With clusters (-F option) the functions are collected in a second buffer,
+// in memory, and printed at the end, one block per file.
+typedef struct gracl_st {
+    char *label; // label of the cluster: file base name, or LIBRARY
+    char *id;    // name of the cluster: label with '.' replaced by '_'
+    int text;    // statement, in the cluster buffer
+    int len;
+    int isnode;  // 1 for a node statement, 0 for a function only called or calling
+} gracl_t;
+
+static char grahl[GRAHLSIZE];       // highlight attributes of nodes and labelled branches
+static char grahlbranch[GRAHLSIZE]; // highlight attributes of branches without label
+
+// With more than one job (-j option), the node and branch statements are
+// collected first and then formatted by the threads, each a slice of them into
+// its own buffer; the buffers are appended in order, so the output is the same
+// as with one job. The blocks of the clusters are shared out the same way,
+// each thread taking a run of whole blocks.
+typedef struct graev_st {
+    symtree_node_t *parent; // node, or caller of the branch
+    symtree_node_t *child;  // callee of the branch, NULL for a node
+    int icolor;             // color of the node, or of the caller, when printed
+} graev_t;
+
+typedef struct grajob_st {
+    graev_t *ev;        // slice of the statements
+    int evno;
+    gracl_t *clnodes;   // run of cluster blocks
+    int clno;
+    const char *cltext; // statements of the clusters
+    outbuf_t buf;
+    treeparam_t *pparam;
+} grajob_t;
+
+// state of one graphviz output; more than one can be written at once (-o option)
+typedef struct gractx_st {
+    outbuf_t out;       // output buffer
+    outbuf_t cl;        // statements of the clusters
+    outbuf_t *cur;      // buffer being written
+    gracl_t *clnodes;   // functions of the clusters
+    int clno;
+    int clmax;
+    graev_t *evs;       // statements waiting to be formatted
+    int evno;
+    int evmax;          // 0 if the statements are formatted at once
+    grajob_t *jobs;
+    int jobno;
+    int bit;            // bit of the output in outlisted
+} gractx_t;
+
+static gractx_t gractx[TT_MAXOUTS];
+static gractx_t *gra = &gractx[0]; // output being written
+
+// append a string to the output
+static void outstr_gra(const char *s)
+{
+    outbuf_str(gra->cur, s);
+}
+
+// append a character to the output
+static void outchar_gra(char c)
+{
+    outbuf_char(gra->cur, c);
+}
+
+// append a number to the output
+static void outint_gra(long n)
+{
+    outbuf_int(gra->cur, n);
+}
+
+// print the statement of a node, without indent and end of line
+static void outnodestmt_gra(outbuf_t *pbuf, symtree_node_t *pnode, int icolor)
+{
+    outbuf_str(pbuf, pnode->funname);
+    if (icolor > 0) {
+        // add style or color attributes for path between root and specified function
+        outbuf_str(pbuf, " [");
+        outbuf_str(pbuf, grahl);
+        // hotter functions of a profile (-P option) get a thicker outline
+        if (icolor > 1) {
+            outbuf_str(pbuf, ",penwidth=");
+            outbuf_int(pbuf, icolor);
+        }
+        outbuf_char(pbuf, ']');
+    }
+    outbuf_char(pbuf, ';');
+}
+
+// print the statement of a branch: caller -> callee;
+static void outbranchstmt_gra(outbuf_t *pbuf, symtree_node_t *parent, symtree_node_t *child, int icolor, treeparam_t *pparam)
+{
+    outbuf_char(pbuf, '\t');
+    outbuf_str(pbuf, parent->funname);
+    outbuf_str(pbuf, "->");
+    outbuf_str(pbuf, child->funname);
+
+    if (pparam->printfile && parent->file) {
+        // if enabled, print the filename where the call has been found
+        outbuf_str(pbuf, " [label=\"");
+        outbuf_str(pbuf, parent->file->basename);
+        outbuf_char(pbuf, '"');
+        if (icolor > 0) {
+            // if path is to be highlighted, add color or style attributes
+            outbuf_char(pbuf, ',');
+            outbuf_str(pbuf, grahl);
+        }
+        outbuf_char(pbuf, ']');
+    } else {
+        // filename is not printed near to the arrow
+        if (icolor > 0) {
+            // if path is to be highlighted, add color or style attributes
+            outbuf_str(pbuf, " [");
+            outbuf_str(pbuf, grahlbranch);
+            outbuf_char(pbuf, ']');
+        }
+    }
+    outbuf_str(pbuf, ";\n");
+}
+
+#ifndef TT_NOTHREADS
+
+// print the statement of a node or branch collected for the threads
+static void outev_gra(outbuf_t *pbuf, graev_t *pev, treeparam_t *pparam)
+{
+    if (pev->child == NULL) {
+        outbuf_char(pbuf, '\t');
+        outnodestmt_gra(pbuf, pev->parent, pev->icolor);
+        outbuf_char(pbuf, '\n');
+    } else {
+        outbranchstmt_gra(pbuf, pev->parent, pev->child, pev->icolor, pparam);
+    }
+}
+
+static void *outjob_gra(void *arg)
+{
+    grajob_t *job = (grajob_t *)arg;
+    int i;
+
+    job->buf.size = 0;
+    for (i = 0; i < job->evno; i++)
+        outev_gra(&job->buf, &job->ev[i], job->pparam);
+
+    return NULL;
+}
+
+// run fn for each job, on the threads, and append their buffers in order
+static void outjobs_gra(void *(*fn)(void *))
+{
+    pthread_t threads[PARMARK_MAXJOBS];
+    int i, started = 1;
+
+    // the calling thread runs the first job, and those of the threads not started
+    for (; started < gra->jobno; started++)
+        if (pthread_create(&threads[started], NULL, fn, &gra->jobs[started]) != 0)
+            break;
+    fn(&gra->jobs[0]);
+    for (i = 1; i < started; i++)
+        pthread_join(threads[i], NULL);
+    for (i = started; i < gra->jobno; i++)
+        fn(&gra->jobs[i]);
+
+    for (i = 0; i < gra->jobno; i++) {
+        if (gra->jobs[i].buf.err)
+            gra->out.err = 1;
+        outbuf_mem(&gra->out, gra->jobs[i].buf.data, gra->jobs[i].buf.size);
+    }
+}
+
+#endif // TT_NOTHREADS
+
+// format the collected statements, a slice for each thread, and append them in order
+static void outevflush_gra(treeparam_t *pparam)
+{
+#ifndef TT_NOTHREADS
+    int i, first, per;
+
+    if (gra->evno == 0)
+        return;
+
+    per = (gra->evno + gra->jobno - 1) / gra->jobno;
+    for (i = 0; i < gra->jobno; i++) {
+        first = i * per < gra->evno ? i * per : gra->evno;
+        gra->jobs[i].ev = gra->evs + first;
+        gra->jobs[i].evno = gra->evno - first < per ? gra->evno - first : per;
+        gra->jobs[i].pparam = pparam;
+    }
+    outjobs_gra(outjob_gra);
+    gra->evno = 0;
+#endif // TT_NOTHREADS
+}
+
+// collect a statement for the threads, formatting them when there are enough
+static void outevadd_gra(symtree_node_t *parent, symtree_node_t *child, int icolor, treeparam_t *pparam)
+{
+    graev_t *pev = &gra->evs[gra->evno++];
+
+    pev->parent = parent;
+    pev->child = child;
+    pev->icolor = icolor;
+    if (gra->evno == gra->evmax)
+        outevflush_gra(pparam);
+}
+
+// write to the output in slot (-o option) from now on
+void outselect_gra(int slot)
+{
+    gra = &gractx[slot];
+    gra->bit = 1 << slot;
+}
+
 // start graph
 int outopen_gra(symtree_t *ptree, treeparam_t *pparam)
 {
     int iErr = 0, iEbase;
     char *sbasename = NULL;
+    char *hl = hlstyles[pparam->hlstyle];
+    symtree_node_t *pnode;
 
-    grafile = fopen(pparam->outfile, "w");
-    if (grafile == NULL) {
-        printf("\nError while opening output file\n");
-        iErr = -1;
+    memset(&gra->cl, 0, sizeof(outbuf_t));
+    gra->cur = &gra->out;
+    gra->clno = 0;
+    iErr = outbuf_open(&gra->out, pparam->outfile);
+    if (iErr != 0)
+        return iErr;
+
+    // the attributes of the highlighted path are the same for every node and branch
+    if (pparam->hlstyle >= HSTYLES1) {
+        snprintf(grahl, GRAHLSIZE, "style=\"%s\"", hl);
+        snprintf(grahlbranch, GRAHLSIZE, "style=\"%s\"", hl);
     } else {
-        // name the graph after the output file base name, without extension
-        iEbase = slibbasename(&sbasename, pparam->outfile, 0);
-        if (iEbase != 0)
-            sbasename = "tceetree"; // on error use this default
-        fprintf(grafile, "digraph %s\n{\n", sbasename);
-        if (iEbase == 0)
-            free(sbasename);
+        snprintf(grahl, GRAHLSIZE, "color=\"%s\",fontcolor=\"%s\"", hl, hl);
+        snprintf(grahlbranch, GRAHLSIZE, "color=\"%s\"", hl);
+    }
+
+    for (pnode = symtree_first(ptree); pnode != NULL; pnode = symtree_next(pnode))
+        pnode->outlisted &= ~gra->bit;
+
+#ifndef TT_NOTHREADS
+    if (pparam->jobs > 1) {
+        gra->jobno = pparam->jobs < PARMARK_MAXJOBS ? pparam->jobs : PARMARK_MAXJOBS;
+        gra->evs = (graev_t *)malloc(GRABATCH * gra->jobno * sizeof(graev_t));
+        gra->jobs = (grajob_t *)calloc(gra->jobno, sizeof(grajob_t));
+        if (gra->evs != NULL && gra->jobs != NULL) {
+            gra->evmax = GRABATCH * gra->jobno;
+        } else {
+            // format at once
+            free(gra->evs);
+            free(gra->jobs);
+            gra->evs = NULL;
+            gra->jobs = NULL;
+            gra->jobno = 0;
+        }
     }
+#endif // TT_NOTHREADS
+
+    // name the graph after the output file base name, without extension
+    iEbase = slibbasename(&sbasename, pparam->outfile, 0);
+    if (iEbase != 0)
+        sbasename = "tceetree"; // on error use this default
+    outstr_gra("digraph ");
+    outstr_gra(sbasename);
+    outstr_gra("\n{\n");
+    if (iEbase == 0)
+        free(sbasename);
 
     return iErr;
 }
 
+// length of the name at the start of a statement
+static int outclnamelen_gra(const char *s)
+{
+    int n;
+
+    for (n = 0; s[n] != ' ' && s[n] != ';'; n++)
+        ;
+
+    return n;
+}
+
+// order the functions of the clusters by cluster, then by name, node
+// statements first, then as printed
+static int cmpcl_gra(const void *a, const void *b)
+{
+    const gracl_t *l = (const gracl_t *)a;
+    const gracl_t *r = (const gracl_t *)b;
+    int c, ln, rn;
+
+    c = l->label == r->label ? 0 : strcmp(l->label, r->label);
+    if (c != 0)
+        return c;
+    ln = outclnamelen_gra(gra->cl.data + l->text);
+    rn = outclnamelen_gra(gra->cl.data + r->text);
+    c = memcmp(gra->cl.data + l->text, gra->cl.data + r->text, ln < rn ? ln : rn);
+    if (c == 0)
+        c = ln - rn;
+    if (c == 0)
+        c = r->isnode - l->isnode;
+    if (c == 0)
+        c = l->text - r->text;
+
+    return c;
+}
+
+// true if the sorted entry i starts the block of a cluster
+static int outclfirst_gra(gracl_t *clnodes, int i)
+{
+    return i == 0 || (clnodes[i].label != clnodes[i - 1].label && strcmp(clnodes[i].label, clnodes[i - 1].label) != 0);
+}
+
+// print the blocks of clno sorted entries, starting at a block, each function once
+static void outclblocks_gra(outbuf_t *pbuf, gracl_t *clnodes, int clno, const char *text)
+{
+    gracl_t *pcl, *pprev;
+    int i, n;
+
+    for (i = 0; i < clno; i++) {
+        pcl = &clnodes[i];
+        n = outclnamelen_gra(text + pcl->text);
+        if (outclfirst_gra(clnodes, i)) {
+            if (i > 0)
+                outbuf_str(pbuf, "\t}\n");
+            outbuf_str(pbuf, "\tsubgraph cluster_");
+            outbuf_str(pbuf, pcl->id);
+            outbuf_str(pbuf, " { label=\"");
+            outbuf_str(pbuf, pcl->label);
+            outbuf_str(pbuf, "\"; labeljust=\"l\";\n");
+        } else {
+            pprev = &clnodes[i - 1];
+            if (n == outclnamelen_gra(text + pprev->text) && memcmp(text + pcl->text, text + pprev->text, n) == 0)
+                continue; // already listed
+        }
+
+        outbuf_str(pbuf, "\t\t");
+        outbuf_mem(pbuf, text + pcl->text, pcl->len);
+        outbuf_char(pbuf, '\n');
+    }
+    if (clno > 0)
+        outbuf_str(pbuf, "\t}\n");
+}
+
+#ifndef TT_NOTHREADS
+
+static void *outcljob_gra(void *arg)
+{
+    grajob_t *job = (grajob_t *)arg;
+
+    job->buf.size = 0;
+    outclblocks_gra(&job->buf, job->clnodes, job->clno, job->cltext);
+
+    return NULL;
+}
+
+#endif // TT_NOTHREADS
+
+// print one block for each cluster with all its functions; with more than one
+// job (-j option) each thread formats a run of blocks into its own buffer
+static void outclusters_gra(void)
+{
+#ifndef TT_NOTHREADS
+    int i, first, last;
+#endif // TT_NOTHREADS
+
+    if (gra->clno > 0)
+        qsort(gra->clnodes, gra->clno, sizeof(gracl_t), cmpcl_gra);
+
+#ifndef TT_NOTHREADS
+    if (gra->jobno > 1) {
+        // about as many entries for each job, moving the cuts to the next block
+        for (i = 0, first = 0; i < gra->jobno; i++, first = last) {
+            last = (int)((long)gra->clno * (i + 1) / gra->jobno);
+            while (last < gra->clno && !outclfirst_gra(gra->clnodes, last))
+                last++;
+            if (last < first)
+                last = first;
+            gra->jobs[i].clnodes = gra->clnodes + first;
+            gra->jobs[i].clno = last - first;
+            gra->jobs[i].cltext = gra->cl.data;
+        }
+        outjobs_gra(outcljob_gra);
+        return;
+    }
+#endif // TT_NOTHREADS
+
+    outclblocks_gra(gra->cur, gra->clnodes, gra->clno, gra->cl.data);
+}
+
 // end graph
 int outclose_gra(symtree_t *ptree, treeparam_t *pparam)
 {
     int iErr = 0;
+    int i;
 
-    fprintf(grafile, "}\n");
+    outevflush_gra(pparam);
 
-    if (fclose(grafile) != 0) {
-        printf("\nError while closing output file\n");
-        iErr = -1;
+    // a failed allocation of the clusters spoils the output too
+    if (gra->cl.err)
+        gra->out.err = 1;
+    if (gra->out.err == 0)
+        outclusters_gra();
+    outstr_gra("}\n");
+
+    for (i = 0; i < gra->jobno; i++)
+        outbuf_free(&gra->jobs[i].buf);
+    free(gra->jobs);
+    free(gra->evs);
+    gra->jobs = NULL;
+    gra->evs = NULL;
+    gra->jobno = gra->evno = gra->evmax = 0;
+
+    iErr = outbuf_close(&gra->out);
+
+    outbuf_free(&gra->cl);
+    free(gra->clnodes);
+    gra->clnodes = NULL;
+    gra->clno = gra->clmax = 0;
+
+    return iErr;
+}
+
+// start collecting a statement for the cluster of the functions defined in file
+static int outclbegin_gra(symtree_file_t *file)
+{
+    gracl_t *pnodes;
+    gracl_t *pcl;
+
+    if (gra->clno == gra->clmax) {
+        pnodes = (gracl_t *)realloc(gra->clnodes, (2 * gra->clmax + 16) * sizeof(gracl_t));
+        if (pnodes == NULL) {
+            printf("\nMemory allocation error\n");
+            return -1;
+        }
+        gra->clnodes = pnodes;
+        gra->clmax = 2 * gra->clmax + 16;
     }
 
-    grafile = NULL;
+    // the file name without path and with extension is the cluster label; if no
+    // file information is present, function will be grouped into the library cluster
+    pcl = &gra->clnodes[gra->clno++];
+    pcl->label = file ? file->basename : TT_LIBRARY;
+    pcl->id = file ? file->clusterid : TT_LIBRARY;
+    pcl->text = gra->cl.size;
+    gra->cur = &gra->cl;
+
+    return 0;
+}
+
+// end the statement started by outclbegin_gra
+static void outclend_gra(int isnode)
+{
+    gracl_t *pcl = &gra->clnodes[gra->clno - 1];
+
+    pcl->len = gra->cl.size - pcl->text;
+    pcl->isnode = isnode;
+    gra->cur = &gra->out;
+}
+
+// list a function in the cluster of its file, unless already there
+static int outlist_gra(symtree_node_t *pnode)
+{
+    int iErr = 0;
+
+    if (!(pnode->outlisted & gra->bit)) {
+        iErr = outclbegin_gra(pnode->file);
+        if (iErr == 0) {
+            outstr_gra(pnode->funname);
+            outchar_gra(';');
+            outclend_gra(0);
+            pnode->outlisted |= gra->bit;
+        }
+    }
 
     return iErr;
 }
@@ -91,54 +531,22 @@ int outclose_gra(symtree_t *ptree, treeparam_t *pparam)
 int outnode_gra(symtree_node_t *pnode, treeparam_t *pparam)
 {
     int iErr = 0;
-    char *sclustername = NULL;
-    char *sclusterlabel = NULL;
-    int i, n;
 
-    if (grafile != NULL && pnode != NULL && pnode->funname != NULL) {
-        fprintf(grafile, "\t");
+    if (gra->out.file != NULL && pnode != NULL && pnode->funname != NULL) {
         if (pparam->doclusters) {
-            // group functions into a cluster for each file
-            // use the filename without path and with extension as the cluster label
-            iErr = slibbasename(&sclusterlabel, pnode->filename, 1);
-            if (iErr == 0) {
-                // if no file information is present, function will be grouped into the library cluster
-                if (sclusterlabel == NULL)
-                    iErr = slibcpy(&sclusterlabel, TT_LIBRARY, 0, -1);
-                if (iErr == 0) {
-                    iErr = slibcpy(&sclustername, sclusterlabel, 0, -1);
-                    if (iErr == 0) {
-                        // replace . with _ for the cluster name
-                        n = strlen(sclustername);
-                        for (i = 0; i < n; i++)
-                            if (sclustername[i] == '.')
-                                sclustername[i] = '_';
-                    }
-                }
-            }
+            // group functions into a cluster for each file, printed at the end
+            iErr = outclbegin_gra(pnode->file);
             if (iErr == 0) {
-                // add statement for assigning function to the cluster
-                fprintf(grafile, "subgraph cluster_%s { label=\"%s\"; labeljust=\"l\"; ", sclustername, sclusterlabel);
+                pnode->outlisted |= gra->bit;
+                outnodestmt_gra(gra->cur, pnode, pnode->icolor);
+                outclend_gra(1);
             }
-            free(sclustername);
-            free(sclusterlabel);
-        }
-
-        if (iErr == 0) {
-            // print node
-            fprintf(grafile, "%s", pnode->funname);
-            if (pnode->icolor > 0) {
-                // add style or color attributes for path between root and specified function
-                if (pparam->hlstyle >= HSTYLES1)
-                    fprintf(grafile, " [style=\"%s\"]", hlstyles[pparam->hlstyle]);
-                else
-                    fprintf(grafile, " [color=\"%s\",fontcolor=\"%s\"]", hlstyles[pparam->hlstyle], hlstyles[pparam->hlstyle]);
-            }
-            fprintf(grafile, ";");
-            // close cluster statement, if cluster enabled
-            if (pparam->doclusters)
-                fprintf(grafile, " }");
-            fprintf(grafile, "\n");
+        } else if (gra->evmax > 0) {
+            outevadd_gra(pnode, NULL, pnode->icolor, pparam);
+        } else {
+            outchar_gra('\t');
+            outnodestmt_gra(gra->cur, pnode, pnode->icolor);
+            outchar_gra('\n');
         }
     }
 
@@ -149,10 +557,9 @@ int outnode_gra(symtree_node_t *pnode, treeparam_t *pparam)
 int outbranch_gra(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int revert_direction)
 {
     int iErr = 0;
-    char *sbasename = NULL;
     symtree_node_t *parent, *child;
 
-    if (!grafile)
+    if (gra->out.file == NULL)
         return 0;
 
     // print the branch: caller -> callee;
@@ -164,34 +571,502 @@ int outbranch_gra(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *p
         child = callee;
     }
 
-    fprintf(grafile, "\t%s->%s", parent->funname, child->funname);
+    // functions only called or calling belong to their cluster too
+    if (pparam->doclusters) {
+        iErr = outlist_gra(parent);
+        if (iErr == 0)
+            iErr = outlist_gra(child);
+        if (iErr != 0)
+            return iErr;
+    }
 
-    if (pparam->printfile && parent->filename) {
-        // if enabled, print the filename where the call has been found
-        iErr = slibbasename(&sbasename, parent->filename, 1);
-        if (iErr == 0) {
-            fprintf(grafile, " [label=\"%s\"", sbasename);
-            if (parent->icolor > 0) {
-                // if path is to be highlighted, add color or style attributes
-                if (pparam->hlstyle >= HSTYLES1)
-                    fprintf(grafile, ",style=\"%s\"", hlstyles[pparam->hlstyle]);
-                else
-                    fprintf(grafile, ",color=\"%s\",fontcolor=\"%s\"", hlstyles[pparam->hlstyle], hlstyles[pparam->hlstyle]);
+    if (gra->evmax > 0)
+        outevadd_gra(parent, child, parent->icolor, pparam);
+    else
+        outbranchstmt_gra(gra->cur, parent, child, parent->icolor, pparam);
+
+    return iErr;
+}
+
+// print one branch weighted by its profile samples: heat > 0 highlights it,
+// heat > 1 also makes it thicker
+int outhotbranch_gra(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam)
+{
+    int iErr = 0;
+
+    if (gra->out.file == NULL)
+        return 0;
+    outevflush_gra(pparam); // keep the order of the statements
+
+    if (pparam->doclusters) {
+        iErr = outlist_gra(caller);
+        if (iErr == 0)
+            iErr = outlist_gra(callee);
+        if (iErr != 0)
+            return iErr;
+    }
+
+    outchar_gra('\t');
+    outstr_gra(caller->funname);
+    outstr_gra("->");
+    outstr_gra(callee->funname);
+    outstr_gra(" [label=\"");
+    if (pparam->printfile && caller->file) {
+        // if enabled, print the filename where the call has been found above the samples
+        outstr_gra(caller->file->basename);
+        outstr_gra("\\n");
+    }
+    outint_gra(samples);
+    outchar_gra('"');
+    if (heat > 0) {
+        outchar_gra(',');
+        outstr_gra(grahl);
+        if (heat > 1) {
+            outstr_gra(",penwidth=");
+            outint_gra(heat);
+        }
+    }
+    outstr_gra("];\n");
+
+    return iErr;
+}
+
+// print a string inside quotes, escaping quotes and backslashes (e.g. of Windows paths)
+static void outescaped_gra(char *s)
+{
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            outchar_gra('\\');
+        outchar_gra(*s);
+    }
+}
+
+// print a quoted name
+static void outquoted_gra(char *s)
+{
+    outchar_gra('"');
+    outescaped_gra(s);
+    outchar_gra('"');
+}
+
+// print the summary node of the functions left out behind a function (-n
+// option), joined to it by a dashed branch
+int outstub_gra(symtree_node_t *pnode, int hidden, treeparam_t *pparam)
+{
+    if (gra->out.file == NULL)
+        return 0;
+    outevflush_gra(pparam); // keep the order of the statements
+
+    outstr_gra("\t\"");
+    outstr_gra(pnode->funname);
+    outstr_gra(" hidden\" [shape=box,style=dashed,label=\"");
+    outint_gra(hidden);
+    outstr_gra(hidden == 1 ? " more function\"];\n\t" : " more functions\"];\n\t");
+    outstr_gra(pnode->funname);
+    outstr_gra("->\"");
+    outstr_gra(pnode->funname);
+    outstr_gra(" hidden\" [style=dashed];\n");
+
+    return 0;
+}
+
+// print one module of the aggregated graph with its number of functions
+int outmodnode_gra(char *name, int funno, treeparam_t *pparam)
+{
+    if (gra->out.file == NULL)
+        return 0;
+    outevflush_gra(pparam); // keep the order of the statements
+
+    outchar_gra('\t');
+    outquoted_gra(name);
+    outstr_gra(" [shape=box,label=\"");
+    outescaped_gra(name);
+    outstr_gra("\\n");
+    outint_gra(funno);
+    outstr_gra(funno == 1 ? " function\"];\n" : " functions\"];\n");
+
+    return 0;
+}
+
+// print one branch of the aggregated graph labelled with the number of calls it stands for
+int outmodbranch_gra(char *caller, char *callee, int count, treeparam_t *pparam)
+{
+    if (gra->out.file == NULL)
+        return 0;
+    outevflush_gra(pparam); // keep the order of the statements
+
+    outchar_gra('\t');
+    outquoted_gra(caller);
+    outstr_gra("->");
+    outquoted_gra(callee);
+    outstr_gra(" [label=\"");
+    outint_gra(count);
+    outstr_gra("\"];\n");
+
+    return 0;
+}
+
+// print the name of a strongly connected component: the function name if it
+// has a single member, a synthetic name otherwise
+static void outsccname_gra(symgraph_t *pgraph, scc_t *pscc, int c)
+{
+    if (pscc->memberstart[c + 1] - pscc->memberstart[c] == 1) {
+        outstr_gra(pgraph->nodes[pscc->member[pscc->memberstart[c]]]->funname);
+    } else {
+        outstr_gra("scc_");
+        outint_gra(c);
+    }
+}
+
+// print one node of the condensed graph, listing all the members of the component
+int outsccnode_gra(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int m, first, last, docluster;
+    symtree_node_t *pnode, *pfirst;
+
+    if (gra->out.file == NULL)
+        return iErr;
+    outevflush_gra(pparam); // keep the order of the statements
+
+    first = pscc->memberstart[c];
+    last = pscc->memberstart[c + 1];
+
+    // cluster only if all members are defined in the same file
+    docluster = pparam->doclusters;
+    pfirst = pgraph->nodes[pscc->member[first]];
+    for (m = first + 1; docluster && m < last; m++) {
+        pnode = pgraph->nodes[pscc->member[m]];
+        if ((pnode->filename == NULL) != (pfirst->filename == NULL) || (pnode->filename && strcmp(pnode->filename, pfirst->filename) != 0))
+            docluster = 0;
+    }
+
+    if (docluster)
+        iErr = outclbegin_gra(pfirst->file);
+    else
+        outchar_gra('\t');
+
+    if (iErr == 0) {
+        outsccname_gra(pgraph, pscc, c);
+        if (last - first > 1) {
+            // recursive cycle: the label lists the member functions
+            outstr_gra(" [shape=box,label=\"");
+            for (m = first; m < last; m++) {
+                if (m > first)
+                    outstr_gra("\\n");
+                outstr_gra(pgraph->nodes[pscc->member[m]]->funname);
+            }
+            outchar_gra('"');
+            if (hl) {
+                outchar_gra(',');
+                outstr_gra(grahl);
             }
-            fprintf(grafile, "]");
-            free(sbasename);
+            outchar_gra(']');
+        } else if (hl) {
+            outstr_gra(" [");
+            outstr_gra(grahl);
+            outchar_gra(']');
         }
+        outchar_gra(';');
+        if (docluster)
+            outclend_gra(1);
+        else
+            outchar_gra('\n');
+    }
+
+    return iErr;
+}
+
+// print one branch of the condensed graph
+int outsccbranch_gra(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symtree_node_t *parent = NULL;
+
+    if (gra->out.file == NULL)
+        return iErr;
+    outevflush_gra(pparam); // keep the order of the statements
+
+    // the calling file is known only when the caller is a single function
+    if (pscc->memberstart[from + 1] - pscc->memberstart[from] == 1)
+        parent = pgraph->nodes[pscc->member[pscc->memberstart[from]]];
+
+    outchar_gra('\t');
+    outsccname_gra(pgraph, pscc, from);
+    outstr_gra("->");
+    outsccname_gra(pgraph, pscc, to);
+
+    if (pparam->printfile && parent && parent->file) {
+        outstr_gra(" [label=\"");
+        outstr_gra(parent->file->basename);
+        outchar_gra('"');
+        if (hl) {
+            outchar_gra(',');
+            outstr_gra(grahl);
+        }
+        outchar_gra(']');
+    } else if (hl) {
+        outstr_gra(" [");
+        outstr_gra(grahlbranch);
+        outchar_gra(']');
+    }
+    outstr_gra(";\n");
+
+    return iErr;
+}
+
+// With pages (-g option) every page is written to its own file; the threads
+// take the next page not yet written until all are.
+typedef struct grapages_st {
+    symgraph_t *pgraph;
+    const int *page;      // page of each node, -1 if not printed
+    const int *pagestart; // nodes of page p: pagenode[pagestart[p]] to pagenode[pagestart[p + 1] - 1]
+    const int *pagenode;
+    char **pagefile;      // file of each page
+    char **pagebase;      // its name without path, in the stubs
+    int pageno;
+    int next; // next page to write
+    int err;
+#ifndef TT_NOTHREADS
+    pthread_mutex_t lock;
+#endif // TT_NOTHREADS
+    treeparam_t *pparam;
+} grapages_t;
+
+// the stubs of a page: one dashed box for each other page it calls or is
+// called from, within the page size; the pages left over share one more box
+typedef struct grastubs_st {
+    int *target; // the other pages, in the order they are found
+    int *box;    // box of page q: q, or pageno for the shared one
+    int *stamp;  // stamp[q] == p once page q is a target of page p
+    int *out;    // out[box] == v once the call of v to the box is printed
+    int *in;     // in[box] == v once the call from the box to v is printed
+} grastubs_t;
+
+// print the name of the box of page q in page p
+static void outpageboxname_gra(outbuf_t *pbuf, grapages_t *pp, grastubs_t *ps, int q)
+{
+    if (ps->box[q] == pp->pageno) {
+        outbuf_str(pbuf, "\"other pages\"");
     } else {
-        // filename is not printed near to the arrow
-        if (parent->icolor > 0) {
-            // if path is to be highlighted, add color or style attributes
-            if (pparam->hlstyle >= HSTYLES1)
-                fprintf(grafile, " [style=\"%s\"]", hlstyles[pparam->hlstyle]);
-            else
-                fprintf(grafile, " [color=\"%s\"]", hlstyles[pparam->hlstyle]);
+        outbuf_str(pbuf, "\"page ");
+        outbuf_int(pbuf, q + 1);
+        outbuf_char(pbuf, '"');
+    }
+}
+
+// find the other pages page p calls or is called from and give them their boxes
+static void outpageboxes_gra(outbuf_t *pbuf, grapages_t *pp, grastubs_t *ps, int p)
+{
+    symgraph_t *pgraph = pp->pgraph;
+    int room = pp->pparam->pagesize - (pp->pagestart[p + 1] - pp->pagestart[p]);
+    int i, j, q, v, targetno = 0;
+
+    for (i = pp->pagestart[p]; i < pp->pagestart[p + 1]; i++) {
+        v = pp->pagenode[i];
+        for (j = pgraph->childstart[v]; j < pgraph->childstart[v + 1]; j++) {
+            q = pp->page[pgraph->child[j]];
+            if (q >= 0 && q != p && ps->stamp[q] != p) {
+                ps->stamp[q] = p;
+                ps->target[targetno++] = q;
+            }
+        }
+        for (j = pgraph->parentstart[v]; j < pgraph->parentstart[v + 1]; j++) {
+            q = pp->page[pgraph->parent[j]];
+            if (q >= 0 && q != p && ps->stamp[q] != p) {
+                ps->stamp[q] = p;
+                ps->target[targetno++] = q;
+            }
         }
     }
-    fprintf(grafile, ";\n");
+
+    // a box of its own for each page while there is room, else the shared one
+    for (i = 0; i < targetno; i++) {
+        q = ps->target[i];
+        ps->box[q] = targetno <= room || i < room - 1 ? q : pp->pageno;
+        ps->out[ps->box[q]] = -1;
+        ps->in[ps->box[q]] = -1;
+        if (ps->box[q] == q) {
+            outbuf_char(pbuf, '\t');
+            outpageboxname_gra(pbuf, pp, ps, q);
+            outbuf_str(pbuf, " [shape=box,style=dashed,label=\"");
+            outbuf_str(pbuf, pp->pagebase[q]);
+            outbuf_str(pbuf, "\"];\n");
+        }
+    }
+    if (targetno > room) {
+        outbuf_str(pbuf, "\t\"other pages\" [shape=box,style=dashed,label=\"");
+        outbuf_int(pbuf, targetno - room + 1);
+        outbuf_str(pbuf, " other pages\"];\n");
+    }
+}
+
+// print the dashed branch between node v of the page and the box of page q,
+// once for each direction
+static void outpagebranch_gra(outbuf_t *pbuf, grapages_t *pp, grastubs_t *ps, int v, int q, int tobox)
+{
+    int *done = tobox ? ps->out : ps->in;
+
+    if (done[ps->box[q]] == v)
+        return;
+    done[ps->box[q]] = v;
+
+    outbuf_char(pbuf, '\t');
+    if (tobox) {
+        outbuf_str(pbuf, pp->pgraph->nodes[v]->funname);
+        outbuf_str(pbuf, "->");
+        outpageboxname_gra(pbuf, pp, ps, q);
+    } else {
+        outpageboxname_gra(pbuf, pp, ps, q);
+        outbuf_str(pbuf, "->");
+        outbuf_str(pbuf, pp->pgraph->nodes[v]->funname);
+    }
+    outbuf_str(pbuf, " [style=dashed];\n");
+}
+
+// print page p: its functions, the calls between them, and the calls from and
+// to the other pages as dashed branches to a box naming the file of the page
+static int outpage_gra(grapages_t *pp, int p, grastubs_t *ps)
+{
+    symgraph_t *pgraph = pp->pgraph;
+    outbuf_t buf;
+    char *sbasename = NULL;
+    int i, j, q, v, w, iErr, iEbase;
+
+    iErr = outbuf_open(&buf, pp->pagefile[p]);
+    if (iErr != 0)
+        return iErr;
+
+    iEbase = slibbasename(&sbasename, pp->pagefile[p], 0);
+    if (iEbase != 0)
+        sbasename = "tceetree"; // on error use this default
+    outbuf_str(&buf, "digraph ");
+    outbuf_str(&buf, sbasename);
+    outbuf_str(&buf, "\n{\n");
+    if (iEbase == 0)
+        free(sbasename);
+
+    for (i = pp->pagestart[p]; i < pp->pagestart[p + 1]; i++) {
+        outbuf_char(&buf, '\t');
+        outnodestmt_gra(&buf, pgraph->nodes[pp->pagenode[i]], pgraph->nodes[pp->pagenode[i]]->icolor);
+        outbuf_char(&buf, '\n');
+    }
+    outpageboxes_gra(&buf, pp, ps, p);
+    for (i = pp->pagestart[p]; i < pp->pagestart[p + 1]; i++) {
+        v = pp->pagenode[i];
+        for (j = pgraph->childstart[v]; j < pgraph->childstart[v + 1]; j++) {
+            w = pgraph->child[j];
+            q = pp->page[w];
+            if (q == p)
+                outbranchstmt_gra(&buf, pgraph->nodes[v], pgraph->nodes[w], pgraph->nodes[v]->icolor, pp->pparam);
+            else if (q >= 0)
+                outpagebranch_gra(&buf, pp, ps, v, q, 1);
+        }
+        for (j = pgraph->parentstart[v]; j < pgraph->parentstart[v + 1]; j++) {
+            q = pp->page[pgraph->parent[j]];
+            if (q >= 0 && q != p)
+                outpagebranch_gra(&buf, pp, ps, v, q, 0);
+        }
+    }
+    outbuf_str(&buf, "}\n");
+
+    return outbuf_close(&buf);
+}
+
+// write the pages until none is left, or one of them failed
+static void *outpagejob_gra(void *arg)
+{
+    grapages_t *pp = (grapages_t *)arg;
+    grastubs_t stubs;
+    int q, p, iErr = 0;
+
+    stubs.target = (int *)malloc((pp->pageno + 1) * sizeof(int));
+    stubs.box = (int *)malloc((pp->pageno + 1) * sizeof(int));
+    stubs.stamp = (int *)malloc((pp->pageno + 1) * sizeof(int));
+    stubs.out = (int *)malloc((pp->pageno + 1) * sizeof(int));
+    stubs.in = (int *)malloc((pp->pageno + 1) * sizeof(int));
+    if (stubs.target == NULL || stubs.box == NULL || stubs.stamp == NULL || stubs.out == NULL || stubs.in == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    } else {
+        for (q = 0; q < pp->pageno; q++)
+            stubs.stamp[q] = -1;
+    }
+
+    for (;;) {
+#ifndef TT_NOTHREADS
+        pthread_mutex_lock(&pp->lock);
+#endif // TT_NOTHREADS
+        if (iErr != 0)
+            pp->err = 1;
+        p = pp->next < pp->pageno && !pp->err ? pp->next++ : -1;
+#ifndef TT_NOTHREADS
+        pthread_mutex_unlock(&pp->lock);
+#endif // TT_NOTHREADS
+        if (p < 0)
+            break;
+        iErr = outpage_gra(pp, p, &stubs);
+    }
+    free(stubs.target);
+    free(stubs.box);
+    free(stubs.stamp);
+    free(stubs.out);
+    free(stubs.in);
+
+    return NULL;
+}
+
+// write every page of a graph split in pages (-g option) to its own file, at
+// the same time with more than one job (-j option)
+int outpages_gra(symgraph_t *pgraph, const int *page, const int *pagestart, const int *pagenode, int pageno, char **pagefile, treeparam_t *pparam)
+{
+    grapages_t pages;
+    int i, iErr = 0;
+#ifndef TT_NOTHREADS
+    pthread_t threads[PARMARK_MAXJOBS];
+    int jobno, started = 1;
+#endif // TT_NOTHREADS
+
+    memset(&pages, 0, sizeof(grapages_t));
+    pages.pgraph = pgraph;
+    pages.page = page;
+    pages.pagestart = pagestart;
+    pages.pagenode = pagenode;
+    pages.pagefile = pagefile;
+    pages.pageno = pageno;
+    pages.pparam = pparam;
+    pages.pagebase = (char **)calloc(pageno + 1, sizeof(char *));
+    if (pages.pagebase == NULL) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+    for (i = 0; iErr == 0 && i < pageno; i++)
+        iErr = slibbasename(&pages.pagebase[i], pagefile[i], 1);
+
+    if (iErr == 0) {
+#ifndef TT_NOTHREADS
+        jobno = pparam->jobs < PARMARK_MAXJOBS ? pparam->jobs : PARMARK_MAXJOBS;
+        if (jobno > pageno)
+            jobno = pageno;
+        pthread_mutex_init(&pages.lock, NULL);
+        // the calling thread writes pages too
+        for (; started < jobno; started++)
+            if (pthread_create(&threads[started], NULL, outpagejob_gra, &pages) != 0)
+                break;
+        outpagejob_gra(&pages);
+        for (i = 1; i < started; i++)
+            pthread_join(threads[i], NULL);
+        pthread_mutex_destroy(&pages.lock);
+#else
+        outpagejob_gra(&pages);
+#endif // TT_NOTHREADS
+        if (pages.err)
+            iErr = -1;
+    }
+
+    for (i = 0; i < pageno; i++)
+        free(pages.pagebase[i]);
+    free(pages.pagebase);
 
     return iErr;
 }
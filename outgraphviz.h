@@ -26,13 +26,26 @@
 #define _OUTGRAPHVIZ_H
 
 #ifndef _ALL_IN_ONE
+#include "scc.h"
 #include "symtree.h"
 #include "ttreeparam.h"
 #endif // _ALL_IN_ONE
 
+#define HSTYLES1 3 // number of colors among the highlight styles
+
+extern char *hlstyles[TT_MAXSTYLES];
+
+void outselect_gra(int slot);
 int outopen_gra(symtree_t *ptree, treeparam_t *pparam);
 int outclose_gra(symtree_t *ptree, treeparam_t *pparam);
 int outnode_gra(symtree_node_t *pnode, treeparam_t *pparam);
 int outbranch_gra(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int reverse_direction);
+int outhotbranch_gra(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam);
+int outstub_gra(symtree_node_t *pnode, int hidden, treeparam_t *pparam);
+int outmodnode_gra(char *name, int funno, treeparam_t *pparam);
+int outmodbranch_gra(char *caller, char *callee, int count, treeparam_t *pparam);
+int outsccnode_gra(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam);
+int outsccbranch_gra(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam);
+int outpages_gra(symgraph_t *pgraph, const int *page, const int *pagestart, const int *pagenode, int pageno, char **pagefile, treeparam_t *pparam);
 
 #endif // #ifndef _OUTGRAPHVIZ_H
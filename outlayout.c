@@ -0,0 +1,1066 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "outbuf.h"
+#include "outgraphviz.h"
+#include "outlayout.h"
+#include "slib.h"
+
+// Built-in layered layout, for the graphs dot takes too long to draw. The
+// nodes and branches are collected as they are printed and placed at the end:
+//  - layers: breadth first depth from the roots, callees one layer below their
+//    caller and callers of the roots above them;
+//  - order in each layer: barycentric sweeps, down and up, each node sorted by
+//    the mean position of its neighbours in the layer it is swept from;
+//  - coordinates: each layer packed left to right with every node as near as
+//    possible to the mean of its neighbours, from the top down and back up.
+// Every step is linear in the nodes and branches but the sorting of the layers.
+// Branches spanning several layers are drawn straight, without the dummy nodes
+// dot puts on them, so that the drawing stays linear in the graph too. The
+// result is SVG, or graphviz input with the positions, for neato -n.
+
+#define LAYSWEEPS 4     // down and up sweeps of the crossing reduction
+#define LAYCHARW 7      // width of a character of the labels (Times 14)
+#define LAYLINEH 17     // height of a line of the labels
+#define LAYPADW 16      // room around the label in the nodes, as dot
+#define LAYPADH 8
+#define LAYMINW 54      // smallest node, as dot
+#define LAYMINH 36
+#define LAYGAPX 18      // room between the nodes of a layer
+#define LAYGAPY 54      // room between the layers
+#define LAYMARGIN 8     // margin of the drawing
+#define LAYNAMESIZE 24  // room for the synthetic name of a component
+
+enum { LAYELLIPSE, LAYBOX, LAYSTUB }; // shapes of the nodes
+
+typedef struct laynode_st {
+    char *name;  // node id
+    char *label; // lines separated by '\n', NULL to show the name
+    int shape;
+    int hl;      // 0 = plain, 1 = highlighted, > 1 = heat of a profile (-P option)
+    int isroot;
+    int layer;
+    int pos;     // index in the layer
+    double bary; // mean position of the neighbours, wanted position when placing
+    int w, h;    // size
+    double x, y; // center
+} laynode_t;
+
+typedef struct layedge_st {
+    int from, to;
+    char *label; // NULL if none
+    int hl;
+    int dashed;
+} layedge_t;
+
+// graph collected for one output; more than one can be written at once (-o option)
+typedef struct layctx_st {
+    outbuf_t file; // output file
+    outbuf_t name; // name being put together, of a summary node (-n option)
+    laynode_t *nodes;
+    int nodeno, nodemax;
+    layedge_t *edges;
+    int edgeno, edgemax;
+    int *hash;     // node index + 1 by hash of the name, 0 if free
+    int hashmax;
+    int err;       // != 0 after an allocation error
+} layctx_t;
+
+static layctx_t layctx[TT_MAXOUTS];
+static layctx_t *lay = &layctx[0]; // output being written
+static double laywidth = 0, layheight = 0;
+
+// graph in adjacency lists and layers, while it is laid out
+static int *layadjstart = NULL; // neighbours of node v from layadj[layadjstart[v]] to layadj[layadjstart[v + 1] - 1]:
+static int *layadj = NULL;      // 2 * index for a callee, 2 * index + 1 for a caller
+static int *layorder = NULL;    // nodes by layer, in their order in the layer
+static int *laystart = NULL;    // first node of each layer in layorder, and the end
+static int layerno = 0;
+
+// note an allocation error, printed once
+static int layfail(void)
+{
+    if (!lay->err)
+        printf("\nMemory allocation error\n");
+    lay->err = 1;
+
+    return -1;
+}
+
+static unsigned int layhashstr(const char *s)
+{
+    unsigned int h = 2166136261u;
+
+    for (; *s; s++)
+        h = (h ^ (unsigned char)*s) * 16777619u;
+
+    return h;
+}
+
+// double the hash table of the node names
+static int layrehash(void)
+{
+    int *hash;
+    int max = lay->hashmax > 0 ? 2 * lay->hashmax : 1024;
+    int i;
+    unsigned int j;
+
+    hash = (int *)calloc(max, sizeof(int));
+    if (hash == NULL)
+        return layfail();
+    for (i = 0; i < lay->nodeno; i++) {
+        for (j = layhashstr(lay->nodes[i].name) & (max - 1); hash[j] != 0; j = (j + 1) & (max - 1))
+            ;
+        hash[j] = i + 1;
+    }
+    free(lay->hash);
+    lay->hash = hash;
+    lay->hashmax = max;
+
+    return 0;
+}
+
+// index of the node with a name, added if new; -1 on allocation error
+static int laynode(const char *name)
+{
+    laynode_t *pnodes;
+    unsigned int j;
+
+    if (lay->err)
+        return -1;
+    if (2 * (lay->nodeno + 1) > lay->hashmax && layrehash() != 0)
+        return -1;
+
+    for (j = layhashstr(name) & (lay->hashmax - 1); lay->hash[j] != 0; j = (j + 1) & (lay->hashmax - 1))
+        if (strcmp(lay->nodes[lay->hash[j] - 1].name, name) == 0)
+            return lay->hash[j] - 1;
+
+    if (lay->nodeno == lay->nodemax) {
+        pnodes = (laynode_t *)realloc(lay->nodes, (2 * lay->nodemax + 1024) * sizeof(laynode_t));
+        if (pnodes == NULL)
+            return layfail();
+        lay->nodes = pnodes;
+        lay->nodemax = 2 * lay->nodemax + 1024;
+    }
+    memset(&lay->nodes[lay->nodeno], 0, sizeof(laynode_t));
+    lay->nodes[lay->nodeno].name = strdup(name);
+    if (lay->nodes[lay->nodeno].name == NULL)
+        return layfail();
+    lay->hash[j] = lay->nodeno + 1;
+
+    return lay->nodeno++;
+}
+
+// node of a function
+static int layfun(symtree_node_t *pnode)
+{
+    int i = laynode(pnode->funname);
+
+    if (i >= 0 && pnode->isroot)
+        lay->nodes[i].isroot = 1;
+
+    return i;
+}
+
+// give a node a shape and a label, which it takes over
+static int laylabel(int i, int shape, char *label)
+{
+    if (i < 0 || label == NULL) {
+        free(label);
+        return i < 0 ? -1 : layfail();
+    }
+    free(lay->nodes[i].label);
+    lay->nodes[i].label = label;
+    lay->nodes[i].shape = shape;
+
+    return 0;
+}
+
+// add a branch, which takes over the label
+static int layedge(int from, int to, char *label, int hl, int dashed)
+{
+    layedge_t *pedges;
+
+    if (from < 0 || to < 0) {
+        free(label);
+        return -1;
+    }
+    if (lay->edgeno == lay->edgemax) {
+        pedges = (layedge_t *)realloc(lay->edges, (2 * lay->edgemax + 1024) * sizeof(layedge_t));
+        if (pedges == NULL) {
+            free(label);
+            return layfail();
+        }
+        lay->edges = pedges;
+        lay->edgemax = 2 * lay->edgemax + 1024;
+    }
+    lay->edges[lay->edgeno].from = from;
+    lay->edges[lay->edgeno].to = to;
+    lay->edges[lay->edgeno].label = label;
+    lay->edges[lay->edgeno].hl = hl;
+    lay->edges[lay->edgeno].dashed = dashed;
+    lay->edgeno++;
+
+    return 0;
+}
+
+// label made of a number and its unit, below a text if any (e.g. "main.c\n42")
+static char *laynumlabel(const char *text, long n, const char *unit)
+{
+    char *s;
+
+    s = (char *)malloc((text ? strlen(text) + 1 : 0) + strlen(unit) + 24);
+    if (s == NULL)
+        return NULL;
+    if (text)
+        sprintf(s, "%s\n%ld%s", text, n, unit);
+    else
+        sprintf(s, "%ld%s", n, unit);
+
+    return s;
+}
+
+// copy of a label, NULL for none
+static int laycopy(const char *s, char **plabel)
+{
+    *plabel = NULL;
+    if (s == NULL)
+        return 0;
+    *plabel = strdup(s);
+
+    return *plabel == NULL ? layfail() : 0;
+}
+
+// breadth first from the nodes queued from head to tail, callees one layer
+// below and callers one layer above; returns the new tail
+static int laybfs(int *queue, int head, int tail, char *seen)
+{
+    int v, w, j;
+
+    while (head < tail) {
+        v = queue[head++];
+        for (j = layadjstart[v]; j < layadjstart[v + 1]; j++) {
+            w = layadj[j] >> 1;
+            if (!seen[w]) {
+                seen[w] = 1;
+                lay->nodes[w].layer = lay->nodes[v].layer + ((layadj[j] & 1) ? -1 : 1);
+                queue[tail++] = w;
+            }
+        }
+    }
+
+    return tail;
+}
+
+// by barycenter, keeping the current order between equal ones
+static int cmpbary(const void *a, const void *b)
+{
+    const laynode_t *l = &lay->nodes[*(const int *)a];
+    const laynode_t *r = &lay->nodes[*(const int *)b];
+
+    if (l->bary != r->bary)
+        return l->bary < r->bary ? -1 : 1;
+
+    return l->pos - r->pos;
+}
+
+// sort layer l by the mean position of the neighbours in layer nl; the nodes
+// without neighbours there stay after the node before them
+static void laysweep(int l, int nl)
+{
+    int i, j, v, w, cnt;
+    double sum, prev = -1;
+
+    for (i = laystart[l]; i < laystart[l + 1]; i++) {
+        v = layorder[i];
+        sum = 0;
+        cnt = 0;
+        for (j = layadjstart[v]; j < layadjstart[v + 1]; j++) {
+            w = layadj[j] >> 1;
+            if (lay->nodes[w].layer == nl) {
+                sum += lay->nodes[w].pos;
+                cnt++;
+            }
+        }
+        lay->nodes[v].bary = cnt > 0 ? sum / cnt : prev;
+        prev = lay->nodes[v].bary;
+    }
+
+    qsort(layorder + laystart[l], laystart[l + 1] - laystart[l], sizeof(int), cmpbary);
+    for (i = laystart[l]; i < laystart[l + 1]; i++)
+        lay->nodes[layorder[i]].pos = i - laystart[l];
+}
+
+// place layer l left to right in its order, each node as near as possible to
+// the mean of its neighbours in layer nl (none if nl < 0), then shift the
+// whole layer by the mean distance left between the nodes and their place
+static void layplace(int l, int nl)
+{
+    int i, j, v, w, cnt, wanted = 0;
+    double sum, x, left = 0, shift = 0;
+    laynode_t *p;
+
+    for (i = laystart[l]; i < laystart[l + 1]; i++) {
+        v = layorder[i];
+        p = &lay->nodes[v];
+        x = left + p->w / 2.0;
+        sum = 0;
+        cnt = 0;
+        if (nl >= 0) {
+            for (j = layadjstart[v]; j < layadjstart[v + 1]; j++) {
+                w = layadj[j] >> 1;
+                if (lay->nodes[w].layer == nl) {
+                    sum += lay->nodes[w].x;
+                    cnt++;
+                }
+            }
+        }
+        if (cnt > 0) {
+            p->bary = sum / cnt;
+            if (i == laystart[l] || p->bary > x)
+                x = p->bary;
+            shift += p->bary - x;
+            wanted++;
+        }
+        p->x = x;
+        left = x + p->w / 2.0 + LAYGAPX;
+    }
+
+    if (wanted > 0) {
+        shift /= wanted;
+        for (i = laystart[l]; i < laystart[l + 1]; i++)
+            lay->nodes[layorder[i]].x += shift;
+    }
+}
+
+// size of a node fitting its label, as dot makes it
+static void laysize(laynode_t *p)
+{
+    const char *s = p->label ? p->label : p->name;
+    int len = 0, maxlen = 0, lines = 1;
+
+    for (; *s; s++) {
+        if (*s == '\n') {
+            lines++;
+            len = 0;
+        } else if (++len > maxlen) {
+            maxlen = len;
+        }
+    }
+
+    p->w = maxlen * LAYCHARW + LAYPADW;
+    p->h = lines * LAYLINEH + LAYPADH;
+    if (p->shape == LAYELLIPSE) {
+        // the ellipse goes through the corners of the label
+        p->w = (int)(p->w * 1.4142 + 0.5);
+        p->h = (int)(p->h * 1.4142 + 0.5);
+    }
+    if (p->w < LAYMINW)
+        p->w = LAYMINW;
+    if (p->h < LAYMINH)
+        p->h = LAYMINH;
+}
+
+// lay out the collected graph: layers, order in the layers, coordinates
+static int laylayout(void)
+{
+    int n = lay->nodeno;
+    int *queue = NULL;
+    char *seen = NULL;
+    int i, j, l, v, e, c, s, tail, pass, minlayer, maxlayer, maxh;
+    double y, minx, maxx;
+    laynode_t *p;
+
+    layadjstart = (int *)malloc((n + 1) * sizeof(int));
+    layadj = (int *)malloc((2 * lay->edgeno + 1) * sizeof(int));
+    queue = (int *)malloc((n + 1) * sizeof(int));
+    seen = (char *)calloc(n + 1, 1);
+    layorder = (int *)malloc((n + 1) * sizeof(int));
+    if (!layadjstart || !layadj || !queue || !seen || !layorder) {
+        free(queue);
+        free(seen);
+        return layfail();
+    }
+
+    // neighbours in both directions, leaving out the calls to itself
+    for (i = 0; i <= n; i++)
+        layadjstart[i] = 0;
+    for (e = 0; e < lay->edgeno; e++) {
+        if (lay->edges[e].from != lay->edges[e].to) {
+            layadjstart[lay->edges[e].from]++;
+            layadjstart[lay->edges[e].to]++;
+        }
+    }
+    for (i = 0, s = 0; i < n; i++) {
+        c = layadjstart[i];
+        layadjstart[i] = s;
+        queue[i] = s;
+        s += c;
+    }
+    layadjstart[n] = s;
+    for (e = 0; e < lay->edgeno; e++) {
+        if (lay->edges[e].from != lay->edges[e].to) {
+            layadj[queue[lay->edges[e].from]++] = 2 * lay->edges[e].to;
+            layadj[queue[lay->edges[e].to]++] = 2 * lay->edges[e].from + 1;
+        }
+    }
+
+    // layers: depth from the roots; a part they do not reach (e.g. modules,
+    // which have no roots) starts from its first node called by no other
+    // node, or else from its first node
+    tail = 0;
+    for (i = 0; i < n; i++) {
+        if (lay->nodes[i].isroot) {
+            seen[i] = 1;
+            lay->nodes[i].layer = 0;
+            queue[tail++] = i;
+        }
+    }
+    tail = laybfs(queue, 0, tail, seen);
+    for (pass = 0; pass < 2; pass++) {
+        for (i = 0; i < n; i++) {
+            if (seen[i])
+                continue;
+            if (pass == 0) {
+                for (j = layadjstart[i]; j < layadjstart[i + 1] && !(layadj[j] & 1); j++)
+                    ;
+                if (j < layadjstart[i + 1])
+                    continue; // called
+            }
+            seen[i] = 1;
+            lay->nodes[i].layer = 0;
+            queue[tail] = i;
+            tail = laybfs(queue, tail, tail + 1, seen);
+        }
+    }
+
+    minlayer = maxlayer = 0;
+    for (i = 0; i < n; i++) {
+        if (lay->nodes[i].layer < minlayer)
+            minlayer = lay->nodes[i].layer;
+        if (lay->nodes[i].layer > maxlayer)
+            maxlayer = lay->nodes[i].layer;
+    }
+    layerno = n > 0 ? maxlayer - minlayer + 1 : 0;
+    laystart = (int *)calloc(layerno + 1, sizeof(int));
+    if (laystart == NULL) {
+        free(queue);
+        free(seen);
+        return layfail();
+    }
+
+    // the first order of each layer is the breadth first one
+    for (i = 0; i < n; i++) {
+        lay->nodes[i].layer -= minlayer;
+        laystart[lay->nodes[i].layer + 1]++;
+    }
+    for (l = 0; l < layerno; l++)
+        laystart[l + 1] += laystart[l];
+    for (i = 0; i < n; i++) {
+        v = queue[i];
+        layorder[laystart[lay->nodes[v].layer]++] = v;
+    }
+    for (l = layerno; l > 0; l--)
+        laystart[l] = laystart[l - 1];
+    laystart[0] = 0;
+    for (l = 0; l < layerno; l++)
+        for (i = laystart[l]; i < laystart[l + 1]; i++)
+            lay->nodes[layorder[i]].pos = i - laystart[l];
+    free(queue);
+    free(seen);
+
+    // crossing reduction
+    for (s = 0; s < LAYSWEEPS; s++) {
+        for (l = 1; l < layerno; l++)
+            laysweep(l, l - 1);
+        for (l = layerno - 2; l >= 0; l--)
+            laysweep(l, l + 1);
+    }
+
+    // coordinates: the layers one below the other, each as high as its
+    // highest node; the nodes under their callers, then the callers over
+    // their callees
+    for (i = 0; i < n; i++)
+        laysize(&lay->nodes[i]);
+    y = LAYMARGIN;
+    for (l = 0; l < layerno; l++) {
+        maxh = 0;
+        for (i = laystart[l]; i < laystart[l + 1]; i++)
+            if (lay->nodes[layorder[i]].h > maxh)
+                maxh = lay->nodes[layorder[i]].h;
+        for (i = laystart[l]; i < laystart[l + 1]; i++)
+            lay->nodes[layorder[i]].y = y + maxh / 2.0;
+        y += maxh + LAYGAPY;
+    }
+    layheight = layerno > 0 ? y - LAYGAPY + LAYMARGIN : 2 * LAYMARGIN;
+
+    if (layerno > 0)
+        layplace(0, -1);
+    for (l = 1; l < layerno; l++)
+        layplace(l, l - 1);
+    for (l = layerno - 2; l >= 0; l--)
+        layplace(l, l + 1);
+
+    minx = maxx = 0;
+    for (i = 0; i < n; i++) {
+        p = &lay->nodes[i];
+        if (i == 0 || p->x - p->w / 2.0 < minx)
+            minx = p->x - p->w / 2.0;
+        if (i == 0 || p->x + p->w / 2.0 > maxx)
+            maxx = p->x + p->w / 2.0;
+    }
+    for (i = 0; i < n; i++)
+        lay->nodes[i].x += LAYMARGIN - minx;
+    laywidth = maxx - minx + 2 * LAYMARGIN;
+
+    return 0;
+}
+
+// print a coordinate, rounded
+static void outnum_lay(double v)
+{
+    outbuf_int(&lay->file, (long)(v >= 0 ? v + 0.5 : v - 0.5));
+}
+
+// print a coordinate attribute of SVG
+static void outsvgnum_lay(const char *name, double v)
+{
+    outbuf_char(&lay->file, ' ');
+    outbuf_str(&lay->file, name);
+    outbuf_str(&lay->file, "=\"");
+    outnum_lay(v);
+    outbuf_char(&lay->file, '"');
+}
+
+// highlight attributes of an SVG shape or branch
+static void outsvghl_lay(int hl, treeparam_t *pparam)
+{
+    if (hl <= 0)
+        return;
+
+    if (pparam->hlstyle < HSTYLES1) {
+        outbuf_str(&lay->file, " stroke=\"");
+        outbuf_str(&lay->file, hlstyles[pparam->hlstyle]);
+        outbuf_char(&lay->file, '"');
+    } else if (pparam->hlstyle > HSTYLES1) {
+        // dashed or dotted
+        outbuf_str(&lay->file, pparam->hlstyle == HSTYLES1 + 1 ? " stroke-dasharray=\"5,2\"" : " stroke-dasharray=\"1,3\"");
+    } else if (hl == 1) {
+        outbuf_str(&lay->file, " stroke-width=\"2\""); // bold
+    }
+    // hotter functions and calls of a profile (-P option) are thicker
+    if (hl > 1) {
+        outbuf_str(&lay->file, " stroke-width=\"");
+        outbuf_int(&lay->file, hl);
+        outbuf_char(&lay->file, '"');
+    }
+}
+
+// print the lines of a label centered on x, y
+static void outsvgtext_lay(const char *s, double x, double y, int hl, treeparam_t *pparam)
+{
+    char c[2] = { 0, 0 };
+    int lines = 1, i;
+
+    for (i = 0; s[i]; i++)
+        if (s[i] == '\n')
+            lines++;
+
+    outbuf_str(&lay->file, "<text");
+    outsvgnum_lay("x", x);
+    // the baseline of the first line: a third of a line below the middle of it
+    outsvgnum_lay("y", y - (lines - 1) * LAYLINEH / 2.0 + LAYLINEH / 3.0);
+    if (hl > 0 && pparam->hlstyle < HSTYLES1) {
+        outbuf_str(&lay->file, " fill=\"");
+        outbuf_str(&lay->file, hlstyles[pparam->hlstyle]);
+        outbuf_char(&lay->file, '"');
+    }
+    outbuf_char(&lay->file, '>');
+    // each line after the first is a tspan one line below the previous one
+    for (; *s; s++) {
+        if (*s == '\n') {
+            outbuf_str(&lay->file, "<tspan");
+            outsvgnum_lay("x", x);
+            outsvgnum_lay("dy", LAYLINEH);
+            outbuf_char(&lay->file, '>');
+        } else {
+            c[0] = *s;
+            outbuf_xml(&lay->file, c);
+        }
+    }
+    for (i = 1; i < lines; i++)
+        outbuf_str(&lay->file, "</tspan>");
+    outbuf_str(&lay->file, "</text>");
+}
+
+// print the SVG drawing
+static void outsvg_lay(treeparam_t *pparam, const char *title)
+{
+    int i, upper;
+    double x1, y1, x2, y2;
+    laynode_t *pf, *pt, *p;
+    layedge_t *pe;
+
+    outbuf_str(&lay->file, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<svg xmlns=\"http://www.w3.org/2000/svg\"");
+    outsvgnum_lay("width", laywidth);
+    outsvgnum_lay("height", layheight);
+    outbuf_str(&lay->file, " viewBox=\"0 0 ");
+    outnum_lay(laywidth);
+    outbuf_char(&lay->file, ' ');
+    outnum_lay(layheight);
+    outbuf_str(&lay->file, "\" font-family=\"Times,serif\" font-size=\"14\" text-anchor=\"middle\">\n<title>");
+    outbuf_xml(&lay->file, title);
+    outbuf_str(&lay->file, "</title>\n<defs>\n"
+                         "<marker id=\"arrow\" viewBox=\"0 0 10 10\" refX=\"10\" refY=\"5\" markerWidth=\"10\" markerHeight=\"10\" markerUnits=\"userSpaceOnUse\" orient=\"auto\">"
+                         "<path d=\"M0,0L10,5L0,10z\"/></marker>\n"
+                         "<marker id=\"arrowhl\" viewBox=\"0 0 10 10\" refX=\"10\" refY=\"5\" markerWidth=\"10\" markerHeight=\"10\" markerUnits=\"userSpaceOnUse\" orient=\"auto\">"
+                         "<path d=\"M0,0L10,5L0,10z\" fill=\"");
+    outbuf_str(&lay->file, pparam->hlstyle < HSTYLES1 ? hlstyles[pparam->hlstyle] : "black");
+    outbuf_str(&lay->file, "\"/></marker>\n</defs>\n<g fill=\"none\" stroke=\"black\">\n");
+
+    // branches from the bottom of the caller to the top of the callee, or the
+    // other way round when going up; sideways within a layer
+    for (i = 0; i < lay->edgeno; i++) {
+        pe = &lay->edges[i];
+        pf = &lay->nodes[pe->from];
+        pt = &lay->nodes[pe->to];
+        outbuf_str(&lay->file, "<path d=\"M");
+        if (pe->from == pe->to) {
+            // loop on the right side
+            x1 = pf->x + pf->w / 2.0;
+            outnum_lay(x1);
+            outbuf_char(&lay->file, ',');
+            outnum_lay(pf->y - 6);
+            outbuf_char(&lay->file, 'C');
+            outnum_lay(x1 + 30);
+            outbuf_char(&lay->file, ',');
+            outnum_lay(pf->y - 24);
+            outbuf_char(&lay->file, ' ');
+            outnum_lay(x1 + 30);
+            outbuf_char(&lay->file, ',');
+            outnum_lay(pf->y + 24);
+            outbuf_char(&lay->file, ' ');
+            outnum_lay(x1);
+            outbuf_char(&lay->file, ',');
+            outnum_lay(pf->y + 6);
+        } else {
+            if (pf->layer != pt->layer) {
+                upper = pf->layer > pt->layer ? -1 : 1;
+                x1 = pf->x;
+                y1 = pf->y + upper * pf->h / 2.0;
+                x2 = pt->x;
+                y2 = pt->y - upper * pt->h / 2.0;
+            } else {
+                upper = pf->x > pt->x ? -1 : 1;
+                x1 = pf->x + upper * pf->w / 2.0;
+                y1 = pf->y;
+                x2 = pt->x - upper * pt->w / 2.0;
+                y2 = pt->y;
+            }
+            outnum_lay(x1);
+            outbuf_char(&lay->file, ',');
+            outnum_lay(y1);
+            outbuf_char(&lay->file, 'L');
+            outnum_lay(x2);
+            outbuf_char(&lay->file, ',');
+            outnum_lay(y2);
+        }
+        outbuf_char(&lay->file, '"');
+        if (pe->dashed)
+            outbuf_str(&lay->file, " stroke-dasharray=\"5,2\"");
+        outsvghl_lay(pe->hl, pparam);
+        outbuf_str(&lay->file, pe->hl > 0 ? " marker-end=\"url(#arrowhl)\"/>\n" : " marker-end=\"url(#arrow)\"/>\n");
+    }
+    outbuf_str(&lay->file, "</g>\n<g font-size=\"10\">\n");
+
+    // branch labels in the middle of the branches
+    for (i = 0; i < lay->edgeno; i++) {
+        pe = &lay->edges[i];
+        if (pe->label == NULL)
+            continue;
+        pf = &lay->nodes[pe->from];
+        pt = &lay->nodes[pe->to];
+        if (pe->from == pe->to)
+            outsvgtext_lay(pe->label, pf->x + pf->w / 2.0 + 40, pf->y, pe->hl, pparam);
+        else
+            outsvgtext_lay(pe->label, (pf->x + pt->x) / 2, (pf->y + pt->y) / 2, pe->hl, pparam);
+        outbuf_char(&lay->file, '\n');
+    }
+    outbuf_str(&lay->file, "</g>\n<g fill=\"white\" stroke=\"black\">\n");
+
+    // nodes, over the branches, with their name as tooltip
+    for (i = 0; i < lay->nodeno; i++) {
+        p = &lay->nodes[i];
+        outbuf_str(&lay->file, "<g><title>");
+        outbuf_xml(&lay->file, p->name);
+        outbuf_str(&lay->file, "</title>");
+        if (p->shape == LAYELLIPSE) {
+            outbuf_str(&lay->file, "<ellipse");
+            outsvgnum_lay("cx", p->x);
+            outsvgnum_lay("cy", p->y);
+            outsvgnum_lay("rx", p->w / 2.0);
+            outsvgnum_lay("ry", p->h / 2.0);
+        } else {
+            outbuf_str(&lay->file, "<rect");
+            outsvgnum_lay("x", p->x - p->w / 2.0);
+            outsvgnum_lay("y", p->y - p->h / 2.0);
+            outsvgnum_lay("width", p->w);
+            outsvgnum_lay("height", p->h);
+            if (p->shape == LAYSTUB)
+                outbuf_str(&lay->file, " stroke-dasharray=\"5,2\"");
+        }
+        outsvghl_lay(p->hl, pparam);
+        outbuf_str(&lay->file, "/><g fill=\"black\" stroke=\"none\">");
+        outsvgtext_lay(p->label ? p->label : p->name, p->x, p->y, p->hl, pparam);
+        outbuf_str(&lay->file, "</g></g>\n");
+    }
+    outbuf_str(&lay->file, "</g>\n</svg>\n");
+}
+
+// print a quoted string for graphviz, with the new lines as \n
+static void outdotstr_lay(const char *s)
+{
+    outbuf_char(&lay->file, '"');
+    for (; *s; s++) {
+        if (*s == '\n') {
+            outbuf_str(&lay->file, "\\n");
+            continue;
+        }
+        if (*s == '"' || *s == '\\')
+            outbuf_char(&lay->file, '\\');
+        outbuf_char(&lay->file, *s);
+    }
+    outbuf_char(&lay->file, '"');
+}
+
+// start the next attribute of a graphviz statement
+static void outdotattr_lay(int *pattrno)
+{
+    outbuf_str(&lay->file, (*pattrno)++ == 0 ? " [" : ",");
+}
+
+// highlight attributes of a graphviz node or branch, as in the graphviz output
+static void outdothl_lay(int hl, int isnode, int *pattrno, treeparam_t *pparam)
+{
+    char *style = hlstyles[pparam->hlstyle];
+
+    if (hl <= 0)
+        return;
+
+    outdotattr_lay(pattrno);
+    if (pparam->hlstyle >= HSTYLES1) {
+        outbuf_str(&lay->file, "style=");
+        outdotstr_lay(style);
+    } else {
+        outbuf_str(&lay->file, "color=");
+        outdotstr_lay(style);
+        if (isnode) {
+            outbuf_str(&lay->file, ",fontcolor=");
+            outdotstr_lay(style);
+        }
+    }
+    if (hl > 1) {
+        outbuf_str(&lay->file, ",penwidth=");
+        outbuf_int(&lay->file, hl);
+    }
+}
+
+// print the graph for neato -n: the nodes at their place, y going up
+static void outdot_lay(treeparam_t *pparam, const char *title)
+{
+    int i, attrno;
+    laynode_t *p;
+    layedge_t *pe;
+
+    outbuf_str(&lay->file, "digraph ");
+    outbuf_str(&lay->file, title);
+    outbuf_str(&lay->file, "\n{\n");
+
+    for (i = 0; i < lay->nodeno; i++) {
+        p = &lay->nodes[i];
+        outbuf_char(&lay->file, '\t');
+        outdotstr_lay(p->name);
+        outbuf_str(&lay->file, " [pos=\"");
+        outnum_lay(p->x);
+        outbuf_char(&lay->file, ',');
+        outnum_lay(layheight - p->y);
+        outbuf_char(&lay->file, '"');
+        attrno = 1;
+        if (p->shape != LAYELLIPSE)
+            outbuf_str(&lay->file, p->shape == LAYSTUB ? ",shape=box,style=dashed" : ",shape=box");
+        if (p->label != NULL) {
+            outbuf_str(&lay->file, ",label=");
+            outdotstr_lay(p->label);
+        }
+        outdothl_lay(p->hl, 1, &attrno, pparam);
+        outbuf_str(&lay->file, "];\n");
+    }
+
+    for (i = 0; i < lay->edgeno; i++) {
+        pe = &lay->edges[i];
+        outbuf_char(&lay->file, '\t');
+        outdotstr_lay(lay->nodes[pe->from].name);
+        outbuf_str(&lay->file, "->");
+        outdotstr_lay(lay->nodes[pe->to].name);
+        attrno = 0;
+        if (pe->label != NULL) {
+            outdotattr_lay(&attrno);
+            outbuf_str(&lay->file, "label=");
+            outdotstr_lay(pe->label);
+        }
+        if (pe->dashed) {
+            outdotattr_lay(&attrno);
+            outbuf_str(&lay->file, "style=dashed");
+        }
+        outdothl_lay(pe->hl, 0, &attrno, pparam);
+        outbuf_str(&lay->file, attrno > 0 ? "];\n" : ";\n");
+    }
+    outbuf_str(&lay->file, "}\n");
+}
+
+// free the collected graph
+static void layfree(void)
+{
+    int i;
+
+    for (i = 0; i < lay->nodeno; i++) {
+        free(lay->nodes[i].name);
+        free(lay->nodes[i].label);
+    }
+    for (i = 0; i < lay->edgeno; i++)
+        free(lay->edges[i].label);
+    free(lay->nodes);
+    free(lay->edges);
+    free(lay->hash);
+    outbuf_free(&lay->name);
+    free(layadjstart);
+    free(layadj);
+    free(layorder);
+    free(laystart);
+    lay->nodes = NULL;
+    lay->edges = NULL;
+    lay->hash = NULL;
+    layadjstart = layadj = layorder = laystart = NULL;
+    lay->nodeno = lay->nodemax = lay->edgeno = lay->edgemax = lay->hashmax = layerno = 0;
+}
+
+// write to the output in slot (-o option) from now on
+void outselect_lay(int slot)
+{
+    lay = &layctx[slot];
+}
+
+// start output: nothing is written before the whole graph is known
+int outopen_lay(symtree_t *ptree, treeparam_t *pparam)
+{
+    layfree();
+    lay->err = 0;
+
+    return outbuf_open(&lay->file, pparam->outfile);
+}
+
+// lay out the graph and print it
+int outclose_lay(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0, iEbase;
+    char *sbasename = NULL;
+
+    if (lay->err == 0)
+        iErr = laylayout();
+
+    if (iErr == 0 && lay->err == 0) {
+        // name the graph after the output file base name, without extension
+        iEbase = slibbasename(&sbasename, pparam->outfile, 0);
+        if (iEbase != 0)
+            sbasename = "tceetree"; // on error use this default
+        if (pparam->outtype == TREEOUT_SVG)
+            outsvg_lay(pparam, sbasename);
+        else
+            outdot_lay(pparam, sbasename);
+        if (iEbase == 0)
+            free(sbasename);
+    } else {
+        lay->file.err = 1;
+    }
+
+    if (outbuf_close(&lay->file) != 0)
+        iErr = -1;
+    layfree();
+
+    return iErr;
+}
+
+// print one node
+int outnode_lay(symtree_node_t *pnode, treeparam_t *pparam)
+{
+    int i;
+
+    if (pnode == NULL || pnode->funname == NULL)
+        return 0;
+
+    i = layfun(pnode);
+    if (i < 0)
+        return -1;
+    lay->nodes[i].hl = pnode->icolor;
+
+    return 0;
+}
+
+// print one branch, with the file where the call is
+int outbranch_lay(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int revert_direction)
+{
+    symtree_node_t *parent, *child;
+    char *label;
+    int from, to;
+
+    if (revert_direction) {
+        parent = callee;
+        child = caller;
+    } else {
+        parent = caller;
+        child = callee;
+    }
+
+    from = layfun(parent);
+    to = layfun(child);
+    if (laycopy(pparam->printfile && parent->file ? parent->file->basename : NULL, &label) != 0)
+        return -1;
+
+    return layedge(from, to, label, parent->icolor > 0, 0);
+}
+
+// print one branch weighted by its profile samples
+int outhotbranch_lay(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam)
+{
+    char *label;
+    int from, to;
+
+    from = layfun(caller);
+    to = layfun(callee);
+    label = laynumlabel(pparam->printfile && caller->file ? caller->file->basename : NULL, samples, "");
+    if (label == NULL)
+        return layfail();
+
+    return layedge(from, to, label, heat, 0);
+}
+
+// print the summary node of the functions left out behind a function (-n
+// option), joined to it by a dashed branch
+int outstub_lay(symtree_node_t *pnode, int hidden, treeparam_t *pparam)
+{
+    int from, to;
+
+    lay->name.size = 0;
+    outbuf_str(&lay->name, pnode->funname);
+    outbuf_mem(&lay->name, " hidden", sizeof(" hidden"));
+    if (lay->name.err)
+        return layfail();
+
+    from = layfun(pnode);
+    to = laynode(lay->name.data);
+    if (laylabel(to, LAYSTUB, laynumlabel(NULL, hidden, hidden == 1 ? " more function" : " more functions")) != 0)
+        return -1;
+
+    return layedge(from, to, NULL, 0, 1);
+}
+
+// print one module of the aggregated graph with its number of functions
+int outmodnode_lay(char *name, int funno, treeparam_t *pparam)
+{
+    return laylabel(laynode(name), LAYBOX, laynumlabel(name, funno, funno == 1 ? " function" : " functions"));
+}
+
+// print one branch of the aggregated graph labelled with the number of calls it stands for
+int outmodbranch_lay(char *caller, char *callee, int count, treeparam_t *pparam)
+{
+    char *label;
+    int from, to;
+
+    from = laynode(caller);
+    to = laynode(callee);
+    label = laynumlabel(NULL, count, "");
+    if (label == NULL)
+        return layfail();
+
+    return layedge(from, to, label, 0, 0);
+}
+
+// name of a strongly connected component: the function name if it has a
+// single member, a synthetic name otherwise
+static char *laysccname(symgraph_t *pgraph, scc_t *pscc, int c, char *name)
+{
+    if (pscc->memberstart[c + 1] - pscc->memberstart[c] == 1)
+        return pgraph->nodes[pscc->member[pscc->memberstart[c]]]->funname;
+
+    snprintf(name, LAYNAMESIZE, "scc_%d", c);
+
+    return name;
+}
+
+// print one node of the condensed graph, listing all the members of the component
+int outsccnode_lay(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam)
+{
+    char name[LAYNAMESIZE];
+    char *label;
+    size_t len = 0;
+    int i, m, first, last;
+    symtree_node_t *pnode;
+
+    first = pscc->memberstart[c];
+    last = pscc->memberstart[c + 1];
+
+    i = laynode(laysccname(pgraph, pscc, c, name));
+    if (i < 0)
+        return -1;
+    if (hl)
+        lay->nodes[i].hl = 1;
+    for (m = first; m < last; m++) {
+        pnode = pgraph->nodes[pscc->member[m]];
+        if (pnode->isroot)
+            lay->nodes[i].isroot = 1;
+        len += strlen(pnode->funname) + 1;
+    }
+    if (last - first == 1)
+        return 0;
+
+    // recursive cycle: the label lists the member functions
+    label = (char *)malloc(len);
+    if (label == NULL)
+        return layfail();
+    label[0] = '\0';
+    for (m = first; m < last; m++) {
+        if (m > first)
+            strcat(label, "\n");
+        strcat(label, pgraph->nodes[pscc->member[m]]->funname);
+    }
+
+    return laylabel(i, LAYBOX, label);
+}
+
+// print one branch of the condensed graph
+int outsccbranch_lay(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam)
+{
+    char fromname[LAYNAMESIZE], toname[LAYNAMESIZE];
+    char *label;
+    int ifrom, ito;
+    symtree_node_t *parent = NULL;
+
+    // the calling file is known only when the caller is a single function
+    if (pscc->memberstart[from + 1] - pscc->memberstart[from] == 1)
+        parent = pgraph->nodes[pscc->member[pscc->memberstart[from]]];
+    if (laycopy(pparam->printfile && parent && parent->file ? parent->file->basename : NULL, &label) != 0)
+        return -1;
+
+    ifrom = laynode(laysccname(pgraph, pscc, from, fromname));
+    ito = laynode(laysccname(pgraph, pscc, to, toname));
+
+    return layedge(ifrom, ito, label, hl, 0);
+}
@@ -0,0 +1,27 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _OUTLAYOUT_H
+#define _OUTLAYOUT_H
+
+#include "scc.h"
+#include "symtree.h"
+#include "ttreeparam.h"
+
+void outselect_lay(int slot);
+int outopen_lay(symtree_t *ptree, treeparam_t *pparam);
+int outclose_lay(symtree_t *ptree, treeparam_t *pparam);
+int outnode_lay(symtree_node_t *pnode, treeparam_t *pparam);
+int outbranch_lay(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int reverse_direction);
+int outhotbranch_lay(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam);
+int outstub_lay(symtree_node_t *pnode, int hidden, treeparam_t *pparam);
+int outmodnode_lay(char *name, int funno, treeparam_t *pparam);
+int outmodbranch_lay(char *caller, char *callee, int count, treeparam_t *pparam);
+int outsccnode_lay(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam);
+int outsccbranch_lay(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam);
+
+#endif //  _OUTLAYOUT_H
@@ -23,249 +23,1227 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 #ifndef _ALL_IN_ONE
 #include "defines.h"
+#include "dobfs.h"
+#include "kpath.h"
+#include "modgraph.h"
+#include "outbuf.h"
+#include "outdata.h"
 #include "outgraphviz.h"
+#include "outlayout.h"
 #include "outtree.h"
+#include "page.h"
+#include "parmark.h"
+#include "profile.h"
+#include "prune.h"
+#include "scc.h"
+#include "slib.h"
+#include "symgraph.h"
 #endif // _ALL_IN_ONE
 
 #define ROOTMARK 0x100 // special value used to find the path to be highlighted (-p option)
+#define MARKONLY -2    // special value used to mark the output subgraph without printing it
+#define HEATLEVELS 4   // heat levels of the profile output: plain, highlighted, thicker, thickest
+
+// functions of an output backend
+typedef struct outbackend_st {
+    void (*select)(int slot);
+    int (*open)(symtree_t *ptree, treeparam_t *pparam);
+    int (*close)(symtree_t *ptree, treeparam_t *pparam);
+    int (*node)(symtree_node_t *pnode, treeparam_t *pparam);
+    int (*branch)(symtree_node_t *caller, symtree_node_t *callee, treeparam_t *pparam, int revert_direction);
+    int (*hotbranch)(symtree_node_t *caller, symtree_node_t *callee, long samples, int heat, treeparam_t *pparam);
+    int (*stub)(symtree_node_t *pnode, int hidden, treeparam_t *pparam);
+    int (*modnode)(char *name, int funno, treeparam_t *pparam);
+    int (*modbranch)(char *caller, char *callee, int count, treeparam_t *pparam);
+    int (*sccnode)(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam);
+    int (*sccbranch)(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam);
+} outbackend_t;
+
+// backends, in the order of treeouttype_t
+static const outbackend_t outbackends[TREEOUT_MAXNUM] = {
+    // TREEOUT_GRAPHVIZ
+    { outselect_gra, outopen_gra, outclose_gra, outnode_gra, outbranch_gra, outhotbranch_gra,
+        outstub_gra, outmodnode_gra, outmodbranch_gra, outsccnode_gra, outsccbranch_gra },
+    // TREEOUT_NDJSON
+    { outselect_dat, outopen_dat, outclose_dat, outnode_dat, outbranch_dat, outhotbranch_dat,
+        outstub_dat, outmodnode_dat, outmodbranch_dat, outsccnode_dat, outsccbranch_dat },
+    // TREEOUT_CSV
+    { outselect_dat, outopen_dat, outclose_dat, outnode_dat, outbranch_dat, outhotbranch_dat,
+        outstub_dat, outmodnode_dat, outmodbranch_dat, outsccnode_dat, outsccbranch_dat },
+    // TREEOUT_GRAPHML
+    { outselect_dat, outopen_dat, outclose_dat, outnode_dat, outbranch_dat, outhotbranch_dat,
+        outstub_dat, outmodnode_dat, outmodbranch_dat, outsccnode_dat, outsccbranch_dat },
+    // TREEOUT_STATS
+    { outselect_dat, outopen_dat, outclose_dat, outnode_dat, outbranch_dat, outhotbranch_dat,
+        outstub_dat, outmodnode_dat, outmodbranch_dat, outsccnode_dat, outsccbranch_dat },
+    // TREEOUT_SVG
+    { outselect_lay, outopen_lay, outclose_lay, outnode_lay, outbranch_lay, outhotbranch_lay,
+        outstub_lay, outmodnode_lay, outmodbranch_lay, outsccnode_lay, outsccbranch_lay },
+    // TREEOUT_NEATO
+    { outselect_lay, outopen_lay, outclose_lay, outnode_lay, outbranch_lay, outhotbranch_lay,
+        outstub_lay, outmodnode_lay, outmodbranch_lay, outsccnode_lay, outsccbranch_lay }
+};
+
+// With more than one output file (-o option) the tree is still scanned once:
+// every node and branch goes to the backend of each output in turn, and each
+// backend keeps the state of its outputs apart by slot.
+static const outbackend_t *outbackend[TT_MAXOUTS]; // backend of each output
+static int outno = 0;                              // outputs open
+
+// backend of output k, switched to the state of that output
+static const outbackend_t *outselect(int k)
+{
+    outbackend[k]->select(k);
+
+    return outbackend[k];
+}
+
+// open or close output k: the backend finds its file and type in pparam
+static int outopenclose(symtree_t *ptree, treeparam_t *pparam, int k, int open)
+{
+    int iErr;
+    char *outfile = pparam->outfile;
+    treeouttype_t outtype = pparam->outtype;
+
+    pparam->outfile = pparam->outfiles[k];
+    pparam->outtype = (treeouttype_t)pparam->outtypes[k];
+    if (open)
+        iErr = outselect(k)->open(ptree, pparam);
+    else
+        iErr = outselect(k)->close(ptree, pparam);
+    pparam->outfile = outfile;
+    pparam->outtype = outtype;
+
+    return iErr;
+}
+
+// end output
+int outclose(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0, iErrC;
+    int k;
+
+    for (k = 0; k < outno; k++) {
+        iErrC = outopenclose(ptree, pparam, k, 0);
+        if (iErr == 0)
+            iErr = iErrC;
+    }
+    outno = 0;
+
+    return iErr;
+}
 
 // start output
 int outopen(symtree_t *ptree, treeparam_t *pparam)
 {
     int iErr = 0;
+    int k;
 
-    switch (pparam->outtype) {
-    case TREEOUT_GRAPHVIZ:
-        iErr = outopen_gra(ptree, pparam);
-        break;
-
-    default:
-        iErr = -1;
-        break;
+    outno = 0;
+    for (k = 0; iErr == 0 && k < pparam->outno; k++) {
+        if (pparam->outtypes[k] < 0 || pparam->outtypes[k] >= TREEOUT_MAXNUM)
+            iErr = -1;
+        if (iErr == 0) {
+            outbackend[k] = &outbackends[pparam->outtypes[k]];
+            iErr = outopenclose(ptree, pparam, k, 1);
+        }
+        if (iErr == 0)
+            outno = k + 1;
     }
 
+    // the outputs already open are closed
+    if (iErr != 0)
+        outclose(ptree, pparam);
+
     return iErr;
 }
 
-// end output
-int outclose(symtree_t *ptree, treeparam_t *pparam)
+// print one node with the selected backends
+int outprintnode(symtree_node_t *pnode, treeparam_t *pparam)
 {
     int iErr = 0;
+    int k;
 
-    switch (pparam->outtype) {
-    case TREEOUT_GRAPHVIZ:
-        iErr = outclose_gra(ptree, pparam);
-        break;
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->node(pnode, pparam);
 
-    default:
-        iErr = -1;
-        break;
-    }
+    return iErr;
+}
+
+// print one branch with the selected backends
+int outprintbranch(symtree_node_t *pnode, symtree_node_t *pbranch, treeparam_t *pparam, int revert_direction)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->branch(pnode, pbranch, pparam, revert_direction);
+
+    return iErr;
+}
+
+// print one branch weighted by its profile samples with the selected backends
+int outprinthotbranch(symtree_node_t *pnode, symtree_node_t *pbranch, long samples, int heat, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->hotbranch(pnode, pbranch, samples, heat, pparam);
+
+    return iErr;
+}
+
+// print the summary node of the functions left out behind a function with the selected backends
+int outprintstub(symtree_node_t *pnode, int hidden, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->stub(pnode, hidden, pparam);
+
+    return iErr;
+}
+
+// print one module of the aggregated graph with the selected backends
+int outprintmodnode(char *name, int funno, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->modnode(name, funno, pparam);
+
+    return iErr;
+}
+
+// print one branch of the aggregated graph with the selected backends
+int outprintmodbranch(char *caller, char *callee, int count, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->modbranch(caller, callee, count, pparam);
 
     return iErr;
 }
 
 // output one node
-int outnode(symtree_node_t *pnode, treeparam_t *pparam, int colr)
+int outnode(outscan_t *pscan, int v, treeparam_t *pparam, int colr)
 {
     int iErr = 0;
+    symtree_node_t *pnode = pscan->graph.nodes[v];
 
-    if (pnode && pnode->outdone)
+    if (pscan->done[v])
         return iErr;
 
     if (colr >= 0) {
-        if (colr == ROOTMARK || pnode->icolor == ROOTMARK) {
+        if (colr == ROOTMARK || pscan->color[v] == ROOTMARK) {
             // assign color only while "rootmarking" or if node was previously "rootmarked"
-            pnode->icolor = colr;
+            pscan->color[v] = colr;
         }
     } else {
-        if (pnode->icolor == ROOTMARK)
-            pnode->icolor = 0; // Only "rootmarked", use default color/style
+        if (pscan->color[v] == ROOTMARK)
+            pscan->color[v] = pnode->icolor = 0; // Only "rootmarked", use default color/style
 
-        // output node
-        switch (pparam->outtype) {
-        case TREEOUT_GRAPHVIZ:
-            iErr = outnode_gra(pnode, pparam);
-            break;
-
-        default:
-            iErr = -1;
-            break;
-        }
+        // output node, unless only marking the output subgraph
+        if (colr != MARKONLY)
+            iErr = outprintnode(pnode, pparam);
     }
 
-    pnode->outdone = 1;
+    pscan->done[v] = 1;
 
     return iErr;
 }
 
 // output one branch
-int outbranch(symtree_node_t *pnode, symtree_node_t *pbranch, treeparam_t *pparam, int colr, int revert_direction)
+int outbranch(outscan_t *pscan, int v, int w, treeparam_t *pparam, int colr, int revert_direction)
 {
     int iErr = 0;
-    int i;
+    symtree_node_t *pbranch = pscan->graph.nodes[w];
 
-    if (pbranch && pbranch->outdone)
+    if (pscan->done[w])
         return iErr;
 
     // check if branch should be excluded
+    if (!pscan->keep[v] || !pscan->keep[w])
+        return iErr;
+
+    if (colr >= 0) {
+        if (colr == ROOTMARK || pscan->color[w] == ROOTMARK) {
+            // assign color only while "rootmarking" or if branch was previously "rootmarked"
+            pscan->color[w] = colr;
+        }
+    } else {
+        if (pscan->color[w] == ROOTMARK)
+            pscan->color[w] = pbranch->icolor = 0; // Only "rootmarked", use default color/style
+
+        // output branch, unless only marking the output subgraph
+        if (colr != MARKONLY)
+            iErr = outprintbranch(pscan->graph.nodes[v], pbranch, pparam, revert_direction);
+    }
+
+    pscan->done[w] = 1;
+
+    return iErr;
+}
+
+// check if a node is excluded from the tree (-x option)
+int outexcluded(symtree_node_t *pnode, treeparam_t *pparam)
+{
+    int i;
+
     for (i = 0; i < pparam->excludfno; i++) {
         // check if library excluded
-        if (strcmp(pparam->excludf[i], TT_LIBRARY) == 0 && pbranch->filename == NULL)
-            return iErr;
+        if (strcmp(pparam->excludf[i], TT_LIBRARY) == 0 && pnode->filename == NULL)
+            return 1;
 
-        // check if caller or callee function name matches one of those in the exclusion list
-        if (strcmp(pnode->funname, pparam->excludf[i]) == 0 || strcmp(pbranch->funname, pparam->excludf[i]) == 0)
-            return iErr;
+        // check if node function name matches one of those in the exclusion list
+        if (strcmp(pnode->funname, pparam->excludf[i]) == 0)
+            return 1;
     }
 
-    if (colr >= 0) {
-        if (colr == ROOTMARK || pbranch->icolor == ROOTMARK) {
-            // assign color only while "rootmarking" or if branch was previously "rootmarked"
-            pbranch->icolor = colr;
+    return 0;
+}
+
+// add a node to a queue
+int outqueueadd(outqueue_t *pqueue, int v)
+{
+    int *idx;
+
+    if (pqueue->nodeno == pqueue->maxno) {
+        idx = (int *)realloc(pqueue->idx, (2 * pqueue->maxno + 16) * sizeof(int));
+        if (idx == NULL) {
+            printf("\nMemory allocation error\n");
+            return -1;
+        }
+        pqueue->idx = idx;
+        pqueue->maxno = 2 * pqueue->maxno + 16;
+    }
+    pqueue->idx[pqueue->nodeno++] = v;
+
+    return 0;
+}
+
+// free queue memory
+void outqueuefree(outqueue_t *pqueue)
+{
+    free(pqueue->idx);
+    memset(pqueue, 0, sizeof(outqueue_t));
+}
+
+// scan one level in one direction: each node of the current level outputs the branches
+// to its callees (callers if reverse) not reached yet and queues them for the next level
+int outlevel(outscan_t *pscan, treeparam_t *pparam, outqueue_t *pcur, outqueue_t *pnext, int reverse, int colr)
+{
+    symgraph_t *pgraph = &pscan->graph;
+    int *start = reverse ? pgraph->parentstart : pgraph->childstart;
+    int *adj = reverse ? pgraph->parent : pgraph->child;
+    int i, j, v, w, prevcol;
+    int iErr = 0;
+
+    for (i = 0; iErr == 0 && i < pcur->nodeno; i++) {
+        v = pcur->idx[i];
+
+        if (colr > 0) {
+            if (colr == ROOTMARK) {
+                // if "rootmarking" (colr == ROOTMARK) and the last function of the path
+                // to be highlighted from roots has been found, then stop scanning tree
+                if (pparam->callp)
+                    if (strcmp(pgraph->nodes[v]->funname, pparam->callp) == 0)
+                        continue;
+            } else {
+                // if coloring and this is a root, then stop scanning tree
+                if (pgraph->nodes[v]->isroot)
+                    continue;
+            }
+        }
+
+        for (j = start[v]; iErr == 0 && j < start[v + 1]; j++) {
+            w = adj[j];
+            if (!pscan->done[w]) {
+                // if branch not done
+                prevcol = pscan->color[v];
+                // output branch
+                iErr = outbranch(pscan, v, w, pparam, colr, reverse);
+
+                // queue the subtree, unless the branch has been excluded
+                if (iErr == 0 && pscan->done[w] && w != v)
+                    if (colr <= 0 || colr == ROOTMARK || prevcol == ROOTMARK)
+                        iErr = outqueueadd(pnext, w);
+            }
         }
+
+        pscan->expanded[v] = 1;
+    }
+
+    return iErr;
+}
+
+// output of the subtrees (forward and backward) starting from the given nodes, breadth first:
+// every node is reached at its minimum depth from the start nodes, so that the depth limits
+// are exact and do not depend on the scanning order, and it is never scanned twice
+int outsubtree(outscan_t *pscan, treeparam_t *pparam, int *pstart, int startno, int fdepth, int bdepth, int colr)
+{
+    outqueue_t fcur, fnext, bcur, bnext, swap;
+    int i, v, level;
+    int iErr = 0;
+
+    memset(&fcur, 0, sizeof(outqueue_t));
+    memset(&fnext, 0, sizeof(outqueue_t));
+    memset(&bcur, 0, sizeof(outqueue_t));
+    memset(&bnext, 0, sizeof(outqueue_t));
+
+    // start nodes are at depth 0 in both directions
+    for (i = 0; iErr == 0 && i < startno; i++) {
+        v = pstart[i];
+        if (pscan->expanded[v] || !pscan->keep[v])
+            continue;
+
+        // before scanning subtree, output the node itself
+        iErr = outnode(pscan, v, pparam, colr);
+        if (iErr == 0)
+            iErr = outqueueadd(&fcur, v);
+        if (iErr == 0)
+            iErr = outqueueadd(&bcur, v);
+    }
+
+    for (level = 0; iErr == 0 && (fcur.nodeno > 0 || bcur.nodeno > 0); level++) {
+        // forward (children) scanning
+        if (fdepth < 0 || level < fdepth)
+            iErr = outlevel(pscan, pparam, &fcur, &fnext, 0, colr);
+        // backward (parents) scanning
+        if (iErr == 0 && (bdepth < 0 || level < bdepth))
+            iErr = outlevel(pscan, pparam, &bcur, &bnext, 1, colr);
+
+        swap = fcur;
+        fcur = fnext;
+        fnext = swap;
+        fnext.nodeno = 0;
+        swap = bcur;
+        bcur = bnext;
+        bnext = swap;
+        bnext.nodeno = 0;
+    }
+
+    outqueuefree(&fcur);
+    outqueuefree(&fnext);
+    outqueuefree(&bcur);
+    outqueuefree(&bnext);
+
+    return iErr;
+}
+
+// collect the root nodes
+int outroots(outscan_t *pscan, outqueue_t *proots)
+{
+    int iErr = 0;
+    int i;
+
+    for (i = 0; iErr == 0 && i < pscan->graph.nodeno; i++)
+        if (pscan->graph.nodes[i]->isroot)
+            iErr = outqueueadd(proots, i);
+
+    return iErr;
+}
+
+// output one node of the condensed graph, highlighted if hl != 0
+int outsccnode(symgraph_t *pgraph, scc_t *pscc, int c, int hl, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->sccnode(pgraph, pscc, c, hl, pparam);
+
+    return iErr;
+}
+
+// output one branch of the condensed graph, highlighted if hl != 0
+int outsccbranch(symgraph_t *pgraph, scc_t *pscc, int from, int to, int hl, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int k;
+
+    for (k = 0; iErr == 0 && k < outno; k++)
+        iErr = outselect(k)->sccbranch(pgraph, pscc, from, to, hl, pparam);
+
+    return iErr;
+}
+
+// mark the functions selected by roots, depths and exclusions: keep[i] = 1 if
+// graph node i belongs to the output. Scanning in one direction only, if dist
+// is not NULL it gets the level of each function as dobfs() gives it.
+int outmark(outscan_t *pscan, treeparam_t *pparam, char *keep, int *dist)
+{
+    int iErr = 0;
+    symgraph_t *pgraph = &pscan->graph;
+    symtree_node_t *pnode;
+    outqueue_t roots;
+    int *rootidx;
+    int *level;
+    char *mark;
+    int i, rootno = 0;
+    int forward = pparam->fdepth != 0;
+    int depth = forward ? pparam->fdepth : pparam->bdepth;
+
+    if (pparam->fdepth == 0 || pparam->bdepth == 0) {
+        // scanning in one direction only selects exactly the functions within depth
+        // of the roots, which can be marked on the frozen graph: breadth first
+        // switching direction, level by level on the -j threads; without depth
+        // limit and levels, work stealing on the -j threads
+        rootidx = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+        level = dist ? dist : (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+        mark = (char *)malloc(pgraph->nodeno + 1);
+        if (rootidx == NULL || level == NULL || mark == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        } else {
+            for (i = 0; i < pgraph->nodeno; i++) {
+                keep[i] = pscan->keep[i];
+                if (pgraph->nodes[i]->isroot)
+                    rootidx[rootno++] = i;
+            }
+
+            if (pparam->jobs > 1 && depth == -1 && dist == NULL) {
+                iErr = parmark(pgraph, keep, rootidx, rootno, forward, pparam->jobs, mark);
+            } else {
+                iErr = pardist(pgraph, keep, rootidx, rootno, forward, depth, pparam->jobs, level);
+                for (i = 0; iErr == 0 && i < pgraph->nodeno; i++)
+                    mark[i] = level[i] >= 0;
+            }
+
+            for (i = 0; iErr == 0 && i < pgraph->nodeno; i++) {
+                // same state as left by the tree scanning
+                pnode = pgraph->nodes[i];
+                pscan->done[i] = mark[i];
+                if (mark[i] && pscan->color[i] == ROOTMARK)
+                    pscan->color[i] = pnode->icolor = 0;
+                keep[i] = mark[i];
+            }
+        }
+        free(rootidx);
+        if (level != dist)
+            free(level);
+        free(mark);
     } else {
-        if (pbranch->icolor == ROOTMARK)
-            pbranch->icolor = 0; // Only "rootmarked", use default color/style
+        memset(&roots, 0, sizeof(outqueue_t));
+        iErr = outroots(pscan, &roots);
+        if (iErr == 0)
+            iErr = outsubtree(pscan, pparam, roots.idx, roots.nodeno, pparam->fdepth, pparam->bdepth, MARKONLY);
+        outqueuefree(&roots);
+
+        for (i = 0; i < pgraph->nodeno; i++)
+            keep[i] = pscan->done[i];
+    }
+
+    return iErr;
+}
+
+// output of the functions within depth of the roots scanning in one direction
+// only, on the frozen graph: outmark() gives the level of every function, and each
+// function below the roots is printed with the branch from the first of its
+// callers (callees when scanning the callers) one level up. The levels are
+// printed in order, each grouped by the function the branches come from.
+int outswept(outscan_t *pscan, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t *pgraph = &pscan->graph;
+    symtree_node_t *pnode;
+    char *keep;
+    int *dist, *from, *order, *pos, *count;
+    int *levelstart = NULL, *bylevel = NULL;
+    int *instart, *in;
+    int forward = pparam->fdepth != 0;
+    int i, j, v, w, d, first, last, orderno = 0, maxdist = 0;
+
+    instart = forward ? pgraph->parentstart : pgraph->childstart;
+    in = forward ? pgraph->parent : pgraph->child;
+
+    keep = (char *)malloc(pgraph->nodeno + 1);
+    dist = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    from = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    order = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    pos = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    count = (int *)calloc(pgraph->nodeno + 1, sizeof(int));
+    if (keep == NULL || dist == NULL || from == NULL || order == NULL || pos == NULL || count == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
+
+    if (iErr == 0)
+        iErr = outmark(pscan, pparam, keep, dist);
+
+    if (iErr == 0) {
+        // the roots, in tree order, are the first level
+        for (i = 0; i < pgraph->nodeno; i++)
+            if (dist[i] == 0)
+                order[orderno++] = i;
 
-        // output branch
-        switch (pparam->outtype) {
-        case TREEOUT_GRAPHVIZ:
-            iErr = outbranch_gra(pnode, pbranch, pparam, revert_direction);
-            break;
+        // the branch to each function comes from the first of its callers
+        // (callees) one level up, whatever the order the search found them in
+        // and the number of threads
+        for (w = 0; w < pgraph->nodeno; w++) {
+            from[w] = -1;
+            for (j = instart[w]; dist[w] > 0 && from[w] < 0 && j < instart[w + 1]; j++)
+                if (dist[in[j]] == dist[w] - 1)
+                    from[w] = in[j];
+            if (dist[w] > maxdist)
+                maxdist = dist[w];
+        }
 
-        default:
+        // the functions of each level by index: bylevel[levelstart[d] ..
+        // levelstart[d + 1] - 1], counted in count[] first
+        levelstart = (int *)calloc(maxdist + 2, sizeof(int));
+        bylevel = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+        if (levelstart == NULL || bylevel == NULL) {
+            printf("\nMemory allocation error\n");
             iErr = -1;
-            break;
         }
     }
 
-    pbranch->outdone = 1;
+    if (iErr == 0) {
+        for (w = 0; w < pgraph->nodeno; w++)
+            if (dist[w] >= 0)
+                levelstart[dist[w] + 1]++;
+        for (d = 0; d <= maxdist; d++)
+            levelstart[d + 1] += levelstart[d];
+        for (d = 0; d <= maxdist; d++)
+            count[d] = levelstart[d];
+        for (w = 0; w < pgraph->nodeno; w++)
+            if (dist[w] >= 0)
+                bylevel[count[dist[w]]++] = w;
+        memset(count, 0, (maxdist + 1) * sizeof(int));
+
+        // each level after the one above: grouped by the position of the
+        // function the branches come from, by index within a group
+        for (i = 0; i < orderno; i++)
+            pos[order[i]] = i;
+        first = 0;
+        last = orderno;
+        for (d = 1; d <= maxdist; d++) {
+            for (j = levelstart[d]; j < levelstart[d + 1]; j++)
+                count[pos[from[bylevel[j]]]]++;
+            for (i = first, v = last; i < last; i++) {
+                w = count[i];
+                count[i] = v;
+                v += w;
+            }
+            for (j = levelstart[d]; j < levelstart[d + 1]; j++) {
+                w = bylevel[j];
+                i = count[pos[from[w]]]++;
+                order[i] = w;
+                pos[w] = i;
+            }
+            first = last;
+            last = v;
+        }
+        orderno = last;
+    }
+
+    for (i = 0; iErr == 0 && i < orderno; i++) {
+        w = order[i];
+        pnode = pgraph->nodes[w];
+        if (from[w] < 0)
+            iErr = outprintnode(pnode, pparam);
+        else
+            iErr = outprintbranch(pgraph->nodes[from[w]], pnode, pparam, !forward);
+    }
+
+    free(keep);
+    free(dist);
+    free(from);
+    free(order);
+    free(pos);
+    free(count);
+    free(levelstart);
+    free(bylevel);
 
     return iErr;
 }
 
-// output of a subtree (forward and backward) starting from pnode
-int outsubtree(treeparam_t *pparam, symtree_node_t *pnode, int fdepth, int bdepth, int colr)
+// split the marked functions into pages (-g option), each written to its own
+// file; the output shows the pages and the number of calls between them
+int outpages(symgraph_t *pgraph, treeparam_t *pparam, char *keep)
 {
-    symtree_node_t *pbranch;
-    symtree_list_t *list;
-    int i, prevcol;
     int iErr = 0;
+    int *roots, *order, *page, *pagestart, *count, *target;
+    char **pagefile, **pagename;
+    char tag[24];
+    int i, j, p, q, v, targetno, rootno = 0, pageno = 0, keptno = 0;
 
-    if (pnode == NULL)
-        return iErr;
+    roots = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    order = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    page = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    if (roots == NULL || order == NULL || page == NULL) {
+        printf("\nMemory allocation error\n");
+        free(roots);
+        free(order);
+        free(page);
+        return -1;
+    }
 
-    if (pnode->subtreeoutdone)
-        return iErr;
+    for (i = 0; i < pgraph->nodeno; i++) {
+        if (pgraph->nodes[i]->isroot)
+            roots[rootno++] = i;
+        keptno += keep[i] != 0;
+    }
+    pageno = page_split(pgraph, keep, roots, rootno, pparam->pagesize, order, page);
+    if (pageno < 0)
+        iErr = -1;
 
-    for (i = 0; i < pparam->excludfno; i++) {
-        // check if library excluded
-        if (strcmp(pparam->excludf[i], TT_LIBRARY) == 0 && pnode->filename == NULL)
-            return iErr;
+    pagestart = (int *)malloc((pageno + 1) * sizeof(int));
+    count = (int *)calloc(pageno + 1, sizeof(int));
+    target = (int *)malloc((pageno + 1) * sizeof(int));
+    pagefile = (char **)calloc(pageno + 1, sizeof(char *));
+    pagename = (char **)calloc(pageno + 1, sizeof(char *));
+    if (iErr == 0 && (pagestart == NULL || count == NULL || target == NULL || pagefile == NULL || pagename == NULL)) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
 
-        // check if node function name matches one of those in the exclusion list
-        if (strcmp(pnode->funname, pparam->excludf[i]) == 0)
-            return iErr;
+    // the pages are runs of order[]
+    for (i = keptno - 1; iErr == 0 && i >= 0; i--)
+        pagestart[page[order[i]]] = i;
+
+    // the files of the pages are named after the output file: tceetree_1.out, ...
+    for (p = 0; iErr == 0 && p < pageno; p++) {
+        snprintf(tag, sizeof(tag), "_%d", p + 1);
+        pagefile[p] = outbuf_name(pparam->outfile, tag);
+        if (pagefile[p] == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        } else {
+            iErr = slibbasename(&pagename[p], pagefile[p], 1);
+        }
+    }
+    if (iErr == 0) {
+        pagestart[pageno] = keptno;
+        iErr = outpages_gra(pgraph, page, pagestart, order, pageno, pagefile, pparam);
+    }
+
+    for (p = 0; iErr == 0 && p < pageno; p++)
+        iErr = outprintmodnode(pagename[p], pagestart[p + 1] - pagestart[p], pparam);
+    for (p = 0; iErr == 0 && p < pageno; p++) {
+        // the calls to each other page, in the order they are found
+        targetno = 0;
+        for (i = pagestart[p]; i < pagestart[p + 1]; i++) {
+            v = order[i];
+            for (j = pgraph->childstart[v]; j < pgraph->childstart[v + 1]; j++) {
+                q = page[pgraph->child[j]];
+                if (q >= 0 && q != p && count[q]++ == 0)
+                    target[targetno++] = q;
+            }
+        }
+        for (i = 0; i < targetno; i++) {
+            q = target[i];
+            if (iErr == 0)
+                iErr = outprintmodbranch(pagename[p], pagename[q], count[q], pparam);
+            count[q] = 0;
+        }
+    }
+
+    if (iErr == 0 && pparam->verbose)
+        printf("\n%d functions in %d pages\n", keptno, pageno);
+
+    for (p = 0; p < pageno && pagefile != NULL && pagename != NULL; p++) {
+        free(pagefile[p]);
+        free(pagename[p]);
+    }
+    free(pagefile);
+    free(pagename);
+    free(pagestart);
+    free(count);
+    free(target);
+    free(roots);
+    free(order);
+    free(page);
+
+    return iErr;
+}
+
+// keep the most important of the marked functions within the node budget (-n
+// option): *phidden receives for each kept function the number of functions
+// left out behind it
+int outprune(symgraph_t *pgraph, treeparam_t *pparam, char *keep, int **phidden)
+{
+    int iErr = 0;
+    int *roots, *hidden;
+    int i, rootno = 0, selno = 0, keptno = 0, stubno = 0;
+
+    roots = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    hidden = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    if (roots == NULL || hidden == NULL) {
+        printf("\nMemory allocation error\n");
+        free(roots);
+        free(hidden);
+        return -1;
+    }
+
+    for (i = 0; i < pgraph->nodeno; i++) {
+        if (pgraph->nodes[i]->isroot)
+            roots[rootno++] = i;
+        selno += keep[i] != 0;
+    }
+    iErr = prune(pgraph, keep, roots, rootno, pparam->maxnodes, hidden);
+
+    if (iErr == 0 && pparam->verbose) {
+        for (i = 0; i < pgraph->nodeno; i++) {
+            keptno += keep[i] != 0;
+            stubno += hidden[i] > 0;
+        }
+        printf("\n%d of %d functions kept, %d summary nodes\n", keptno, selno, stubno);
+    }
+
+    free(roots);
+    if (iErr != 0) {
+        free(hidden);
+        hidden = NULL;
+    }
+    *phidden = hidden;
+
+    return iErr;
+}
+
+// output of the marked subgraph as a graph: with -S every recursive cycle is collapsed
+// into one node, with -T the calls implied by longer call chains are left out, with
+// -n only the most important functions are kept
+int outmarked(outscan_t *pscan, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t *pgraph = &pscan->graph;
+    scc_t scc;
+    char *keep;
+    char *keepsucc = NULL;
+    char *hot = NULL;
+    int *stamp = NULL;
+    int *hidden = NULL;
+    int i, c, j, m, k, v;
+
+    keep = (char *)malloc(pgraph->nodeno + 1);
+    if (keep == NULL) {
+        printf("\nMemory allocation error\n");
+        return -1;
     }
 
-    // before scanning subtree, output the node itself
-    iErr = outnode(pnode, pparam, colr);
+    // only the nodes marked by the tree scanning belong to the output
+    iErr = outmark(pscan, pparam, keep, NULL);
+    if (iErr == 0 && pparam->pagesize > 0) {
+        iErr = outpages(pgraph, pparam, keep);
+        free(keep);
+        return iErr;
+    }
+    if (iErr == 0 && pparam->maxnodes > 0)
+        iErr = outprune(pgraph, pparam, keep, &hidden);
+    if (iErr == 0)
+        iErr = scc_build(&scc, pgraph, keep);
+    if (iErr != 0) {
+        free(hidden);
+        free(keep);
+        return iErr;
+    }
 
-    if (colr > 0) {
-        if (colr == ROOTMARK) {
-            // if "rootmarking" (colr == ROOTMARK) and the last function of the path
-            // to be highlighted from roots has been found, then stop scanning tree
-            if (pparam->callp)
-                if (strcmp(pnode->funname, pparam->callp) == 0)
-                    return iErr;
+    if (pparam->reduce) {
+        keepsucc = (char *)malloc(scc.succstart[scc.sccno] + 1);
+        if (keepsucc == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
         } else {
-            // if coloring and this is a root, then stop scanning tree
-            if (pnode->isroot)
-                return iErr;
+            iErr = scc_reduce(&scc, keepsucc);
         }
     }
 
-    if (iErr == 0 && fdepth != 0) {
-        // forward (children) scanning
-        if (fdepth > 0)
-            fdepth--;
+    // a component is highlighted if any member is, for its node and the
+    // branches from it
+    if (iErr == 0 && pparam->condense) {
+        hot = (char *)calloc(scc.sccno + 1, 1);
+        if (hot == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        }
+        for (c = 0; iErr == 0 && c < scc.sccno; c++)
+            for (m = scc.memberstart[c]; m < scc.memberstart[c + 1]; m++)
+                if (pgraph->nodes[scc.member[m]]->icolor > 0)
+                    hot[c] = 1;
+    }
 
-        list = pnode->children;
-        while (list) {
-            pbranch = list->symbol;
-            if (!pbranch->outdone) {
-                // if branch not done
-                prevcol = pnode->icolor;
-                // output branch
-                iErr = outbranch(pnode, pbranch, pparam, colr, 0);
-                if (iErr != 0)
-                    break;
+    // components are in reverse topological order: print callers first
+    if (iErr == 0 && pparam->condense) {
+        for (c = scc.sccno - 1; iErr == 0 && c >= 0; c--)
+            iErr = outsccnode(pgraph, &scc, c, hot[c], pparam);
+        for (c = scc.sccno - 1; iErr == 0 && c >= 0; c--)
+            for (j = scc.succstart[c]; iErr == 0 && j < scc.succstart[c + 1]; j++)
+                if (keepsucc == NULL || keepsucc[j])
+                    iErr = outsccbranch(pgraph, &scc, c, scc.succ[j], hot[c], pparam);
+    } else if (iErr == 0) {
+        stamp = (int *)malloc((scc.sccno + 1) * sizeof(int));
+        if (stamp == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        }
 
-                // do subtree
-                if (pbranch != pnode) // avoid involving recursion in depth decrease
-                    if (colr <= 0 || colr == ROOTMARK || prevcol == ROOTMARK)
-                        iErr = outsubtree(pparam, pbranch, fdepth, 0, colr);
+        for (c = scc.sccno - 1; iErr == 0 && c >= 0; c--)
+            for (m = scc.memberstart[c]; iErr == 0 && m < scc.memberstart[c + 1]; m++)
+                iErr = outprintnode(pgraph->nodes[scc.member[m]], pparam);
+
+        for (c = 0; iErr == 0 && c < scc.sccno; c++)
+            stamp[c] = -1;
+        for (c = scc.sccno - 1; iErr == 0 && c >= 0; c--) {
+            // calls inside a recursive cycle are always kept, calls between
+            // components only if the condensed edge survived the reduction
+            stamp[c] = c;
+            for (j = scc.succstart[c]; j < scc.succstart[c + 1]; j++)
+                if (keepsucc == NULL || keepsucc[j])
+                    stamp[scc.succ[j]] = c;
+
+            for (m = scc.memberstart[c]; iErr == 0 && m < scc.memberstart[c + 1]; m++) {
+                i = scc.member[m];
+                for (k = pgraph->childstart[i]; iErr == 0 && k < pgraph->childstart[i + 1]; k++) {
+                    v = pgraph->child[k];
+                    if (keep[v] && stamp[scc.comp[v]] == c)
+                        iErr = outprintbranch(pgraph->nodes[i], pgraph->nodes[v], pparam, 0);
+                }
             }
-            list = list->next;
         }
     }
 
-    if (iErr == 0 && bdepth != 0) {
-        if (bdepth > 0)
-            bdepth--;
+    // the functions left out by the node budget, summarized behind the kept ones
+    for (i = 0; iErr == 0 && hidden != NULL && i < pgraph->nodeno; i++)
+        if (hidden[i] > 0)
+            iErr = outprintstub(pgraph->nodes[i], hidden[i], pparam);
 
-        list = pnode->parents;
-        while (list) {
-            pbranch = list->symbol;
-            if (!pbranch->outdone) {
-                // if branch not done
-                prevcol = pnode->icolor;
-                // output branch
-                iErr = outbranch(pnode, pbranch, pparam, colr, 1);
-                if (iErr != 0)
-                    break;
+    if (pparam->verbose)
+        printf("\n%d strongly connected components\n", scc.sccno);
 
-                // do subtree
-                if (pbranch != pnode) // avoid involving recursion in depth decrease
-                    if (colr <= 0 || colr == ROOTMARK || prevcol == ROOTMARK)
-                        iErr = outsubtree(pparam, pbranch, 0, bdepth, colr);
+    free(hidden);
+    free(stamp);
+    free(hot);
+    free(keepsucc);
+    scc_free(&scc);
+    free(keep);
+
+    return iErr;
+}
+
+// output of the k shortest call paths from the roots to the -p function (-k option)
+int outpaths(outscan_t *pscan, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t *pgraph = &pscan->graph;
+    kpath_t paths;
+    char *keep = NULL;
+    char *target = NULL;
+    char *printed = NULL;
+    int *src = NULL;
+    int *done = NULL; // branches already printed, as pairs of nodes
+    int forward = pparam->fdepth != 0;
+    int srcno = 0, doneno = 0;
+    int i, j, p, d, from, to;
+
+    keep = (char *)malloc(pgraph->nodeno + 1);
+    target = (char *)malloc(pgraph->nodeno + 1);
+    printed = (char *)calloc(pgraph->nodeno + 1, 1);
+    src = (int *)malloc((pgraph->nodeno + 1) * sizeof(int));
+    if (keep == NULL || target == NULL || printed == NULL || src == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
+
+    if (iErr == 0) {
+        for (i = 0; i < pgraph->nodeno; i++) {
+            keep[i] = pscan->keep[i];
+            target[i] = strcmp(pgraph->nodes[i]->funname, pparam->callp) == 0;
+            if (pgraph->nodes[i]->isroot)
+                src[srcno++] = i;
+        }
+
+        // toward the callees, or toward the callers when scanning callers only
+        iErr = kpath_find(&paths, pgraph, keep, src, srcno, target, forward, pparam->pathno);
+    }
+
+    if (iErr == 0) {
+        done = (int *)malloc((2 * (paths.start[paths.pathno] - paths.pathno) + 1) * sizeof(int));
+        if (done == NULL) {
+            printf("\nMemory allocation error\n");
+            iErr = -1;
+        }
+    }
+
+    if (iErr == 0) {
+        // every function of the paths is highlighted
+        for (j = 0; iErr == 0 && j < paths.start[paths.pathno]; j++) {
+            i = paths.node[j];
+            if (!printed[i]) {
+                printed[i] = 1;
+                pgraph->nodes[i]->icolor = 1;
+                iErr = outprintnode(pgraph->nodes[i], pparam);
+            }
+        }
+
+        // branches shared by more paths are printed once
+        for (p = 0; iErr == 0 && p < paths.pathno; p++) {
+            for (j = paths.start[p]; iErr == 0 && j < paths.start[p + 1] - 1; j++) {
+                from = paths.node[j];
+                to = paths.node[j + 1];
+                for (d = 0; d < doneno && (done[2 * d] != from || done[2 * d + 1] != to); d++)
+                    ;
+                if (d < doneno)
+                    continue;
+                done[2 * doneno] = from;
+                done[2 * doneno++ + 1] = to;
+                iErr = outprintbranch(pgraph->nodes[from], pgraph->nodes[to], pparam, !forward);
+            }
+        }
+
+        if (pparam->verbose) {
+            printf("\n%d call paths found\n", paths.pathno);
+            for (p = 0; p < paths.pathno; p++) {
+                for (j = paths.start[p]; j < paths.start[p + 1]; j++)
+                    printf("%s%s", j > paths.start[p] ? (forward ? " -> " : " <- ") : "", pgraph->nodes[paths.node[j]]->funname);
+                printf("\n");
+            }
+        }
+
+        kpath_free(&paths);
+    }
+
+    free(keep);
+    free(target);
+    free(printed);
+    free(src);
+    free(done);
+
+    return iErr;
+}
+
+// heat level of a weight: 0 below a quarter of the hottest one, up to HEATLEVELS - 1
+static int outheat(long weight, long hottest)
+{
+    int heat;
+
+    if (hottest <= 0)
+        return 0;
+    heat = (int)((double)HEATLEVELS * weight / hottest);
+
+    return heat < HEATLEVELS ? heat : HEATLEVELS - 1;
+}
+
+// output of the hot calls of a profile (-P option): the calls between the selected
+// functions sampled at least the threshold number of times (-w option), labelled
+// with their samples; the hotter a function or a call, the stronger its highlight
+int outprofile(symtree_t *ptree, outscan_t *pscan, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t *pgraph = &pscan->graph;
+    profile_t prof;
+    char *keep;
+    long *inw = NULL;  // samples of the hot calls to each function
+    long *outw = NULL; // samples of the hot calls from each function
+    long minw = pparam->minsamples > 0 ? pparam->minsamples : 1;
+    long w, nodemax = 0, branchmax = 0;
+    int i, k, v, nodeno = 0, branchno = 0;
+
+    keep = (char *)malloc(pgraph->nodeno + 1);
+    if (keep == NULL) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+
+    // the profile weights the calls between the functions selected as usual
+    iErr = outmark(pscan, pparam, keep, NULL);
+    if (iErr == 0)
+        iErr = profile_load(&prof, ptree, pgraph, pparam->proffile);
+    if (iErr != 0) {
+        free(keep);
+        return iErr;
+    }
+
+    inw = (long *)calloc(pgraph->nodeno + 1, sizeof(long));
+    outw = (long *)calloc(pgraph->nodeno + 1, sizeof(long));
+    if (inw == NULL || outw == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    } else {
+        for (i = 0; i < pgraph->nodeno; i++)
+            for (k = pgraph->childstart[i]; keep[i] && k < pgraph->childstart[i + 1]; k++) {
+                v = pgraph->child[k];
+                w = prof.weight[k];
+                if (keep[v] && w >= minw) {
+                    outw[i] += w;
+                    inw[v] += w;
+                    if (w > branchmax)
+                        branchmax = w;
+                }
             }
-            list = list->next;
+
+        // a function weighs as much as the calls to it, or from it for the roots of the profile
+        for (i = 0; i < pgraph->nodeno; i++) {
+            if (outw[i] > inw[i])
+                inw[i] = outw[i];
+            if (inw[i] > nodemax)
+                nodemax = inw[i];
         }
+
+        for (i = 0; iErr == 0 && i < pgraph->nodeno; i++)
+            if (inw[i] > 0) {
+                pgraph->nodes[i]->icolor = outheat(inw[i], nodemax);
+                iErr = outprintnode(pgraph->nodes[i], pparam);
+                nodeno++;
+            }
+
+        for (i = 0; iErr == 0 && i < pgraph->nodeno; i++)
+            for (k = pgraph->childstart[i]; iErr == 0 && keep[i] && k < pgraph->childstart[i + 1]; k++) {
+                v = pgraph->child[k];
+                w = prof.weight[k];
+                if (keep[v] && w >= minw) {
+                    iErr = outprinthotbranch(pgraph->nodes[i], pgraph->nodes[v], w, outheat(w, branchmax), pparam);
+                    branchno++;
+                }
+            }
+
+        if (pparam->verbose)
+            printf("\n%ld samples, %d hot calls between %d functions, %ld profiled calls not in the call graph\n",
+                prof.total, branchno, nodeno, prof.unmatched);
     }
 
-    pnode->subtreeoutdone = 1;
+    free(inw);
+    free(outw);
+    profile_free(&prof);
+    free(keep);
+
+    return iErr;
+}
+
+// output of the call graph between modules, i.e. directories cut to -M components:
+// every call between functions of different modules adds one to the count of
+// the branch between the modules. Without -r all the functions are aggregated.
+int outmodules(outscan_t *pscan, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t *pgraph = &pscan->graph;
+    modgraph_t mgraph;
+    char *keep;
+    int i, m, k, inner = 0;
+
+    keep = (char *)malloc(pgraph->nodeno + 1);
+    if (keep == NULL) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+
+    if (pparam->rootno > 0) {
+        iErr = outmark(pscan, pparam, keep, NULL);
+    } else {
+        for (i = 0; i < pgraph->nodeno; i++)
+            keep[i] = pscan->keep[i];
+    }
+    if (iErr == 0)
+        iErr = modgraph_build(&mgraph, pgraph, keep, pparam->moddepth);
+
+    if (iErr == 0) {
+        for (m = 0; iErr == 0 && m < mgraph.modno; m++) {
+            iErr = outprintmodnode(mgraph.name[m], mgraph.funno[m], pparam);
+            inner += mgraph.inner[m];
+        }
+        for (m = 0; iErr == 0 && m < mgraph.modno; m++)
+            for (k = mgraph.start[m]; iErr == 0 && k < mgraph.start[m + 1]; k++)
+                iErr = outprintmodbranch(mgraph.name[m], mgraph.name[mgraph.to[k]], mgraph.count[k], pparam);
+
+        if (pparam->verbose)
+            printf("\n%d modules, %d branches between modules, %d calls inside modules\n",
+                mgraph.modno, mgraph.start[mgraph.modno], inner);
+
+        modgraph_free(&mgraph);
+    }
+
+    free(keep);
 
     return iErr;
 }
 
 // tree output init
-void outtreeinit(symtree_t *ptree, int color, int resetroot)
+void outtreeinit(symtree_t *ptree)
 {
     symtree_node_t *pnode;
 
     pnode = symtree_first(ptree);
     while (pnode) {
-        pnode->outdone = 0;
-        pnode->subtreeoutdone = 0;
-        if (resetroot)
-            pnode->isroot = 0;
-        if (color >= 0)
-            pnode->icolor = color;
+        pnode->isroot = 0;
+        pnode->icolor = 0;
         pnode = symtree_next(pnode);
     }
 }
 
+// scanning init: the frozen graph, renumbered from the roots, so that every
+// search from them touches nearby memory, and the state of its nodes
+int outscaninit(outscan_t *pscan, symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    int *roots;
+    int i, rootno = 0;
+
+    memset(pscan, 0, sizeof(outscan_t));
+    iErr = symgraph_build(&pscan->graph, ptree);
+    if (iErr != 0)
+        return iErr;
+
+    roots = (int *)malloc((pscan->graph.nodeno + 1) * sizeof(int));
+    pscan->keep = (char *)malloc(pscan->graph.nodeno + 1);
+    pscan->done = (char *)calloc(pscan->graph.nodeno + 1, 1);
+    pscan->expanded = (char *)calloc(pscan->graph.nodeno + 1, 1);
+    pscan->color = (int *)calloc(pscan->graph.nodeno + 1, sizeof(int));
+    if (roots == NULL || pscan->keep == NULL || pscan->done == NULL || pscan->expanded == NULL || pscan->color == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
+
+    if (iErr == 0) {
+        for (i = 0; i < pscan->graph.nodeno; i++)
+            if (pscan->graph.nodes[i]->isroot)
+                roots[rootno++] = i;
+        iErr = symgraph_relabel(&pscan->graph, roots, rootno);
+    }
+
+    for (i = 0; iErr == 0 && i < pscan->graph.nodeno; i++)
+        pscan->keep[i] = !outexcluded(pscan->graph.nodes[i], pparam);
+
+    free(roots);
+
+    return iErr;
+}
+
+// scanning reset, keeping the colors
+void outscanreset(outscan_t *pscan)
+{
+    memset(pscan->done, 0, pscan->graph.nodeno);
+    memset(pscan->expanded, 0, pscan->graph.nodeno);
+}
+
+// free scanning memory
+void outscanfree(outscan_t *pscan)
+{
+    free(pscan->keep);
+    free(pscan->done);
+    free(pscan->expanded);
+    free(pscan->color);
+    symgraph_free(&pscan->graph);
+    memset(pscan, 0, sizeof(outscan_t));
+}
+
 // make tree output
 int outtree(symtree_t *ptree, treeparam_t *pparam)
 {
     int iErr = 0, iErrC;
     symtree_node_t *pnode;
+    outscan_t scan;
+    outqueue_t roots;
     int i = 0;
 
     if (pparam->verbose)
@@ -275,7 +1253,7 @@ int outtree(symtree_t *ptree, treeparam_t *pparam)
     iErr = outopen(ptree, pparam);
     if (iErr == 0) {
         // init, color = 0, reset root flags
-        outtreeinit(ptree, 0, 1);
+        outtreeinit(ptree);
 
         // find all roots and set corresponding isroot flag
         for (i = 0; i < pparam->rootno; i++) {
@@ -290,49 +1268,70 @@ int outtree(symtree_t *ptree, treeparam_t *pparam)
             }
         }
 
-        // mark all nodes found scanning the tree starting from the specified root functions
-        pnode = symtree_first(ptree);
-        while (iErr == 0 && pnode != NULL) {
-            if (pnode->isroot) {
-                // init, don't set color, don't reset isroot flags
-                outtreeinit(ptree, -1, 0);
-                iErr = outsubtree(pparam, pnode, pparam->fdepth, pparam->bdepth, ROOTMARK);
-            }
-
-            pnode = symtree_next(pnode);
-        }
-
-        if (pparam->callp) {
-            // if an highlight path has been specified
-            pnode = symtree_first(ptree);
-            while (iErr == 0 && pnode != NULL) {
-                if (strcmp(pnode->funname, pparam->callp) == 0) {
-                    // found the last function of path
-                    // init, don't set color, don't reset isroot flags
-                    outtreeinit(ptree, -1, 0);
-                    // bdepth and fdepth are inverted on purpose, because we are scanning toward roots
-                    // in the opposite direction
-                    // last parameter = 1 because we are coloring the path
-                    iErr = outsubtree(pparam, pnode, pparam->bdepth, pparam->fdepth, 1);
-                    // break; break missing because the same function can have multiple defintions in different files
+        // the scanning runs on the frozen graph
+        iErr = outscaninit(&scan, ptree, pparam);
+        if (iErr == 0) {
+            if (pparam->pathno > 0 && pparam->callp) {
+                // only the shortest call paths till the highlighted function
+                iErr = outpaths(&scan, pparam);
+            } else if (pparam->moddepth > 0) {
+                // only the modules and the number of calls between them
+                iErr = outmodules(&scan, pparam);
+            } else if (pparam->proffile) {
+                // only the hot calls of the profile
+                iErr = outprofile(ptree, &scan, pparam);
+            } else {
+                // mark all nodes found scanning the tree starting from the specified root functions,
+                // to find the path to be highlighted
+                for (i = 0; iErr == 0 && pparam->callp && i < scan.graph.nodeno; i++) {
+                    if (scan.graph.nodes[i]->isroot) {
+                        // init, don't reset colors
+                        outscanreset(&scan);
+                        iErr = outsubtree(&scan, pparam, &i, 1, pparam->fdepth, pparam->bdepth, ROOTMARK);
+                    }
                 }
 
-                pnode = symtree_next(pnode);
-            }
-        }
+                if (pparam->callp) {
+                    // if an highlight path has been specified
+                    for (i = 0; iErr == 0 && i < scan.graph.nodeno; i++) {
+                        if (strcmp(scan.graph.nodes[i]->funname, pparam->callp) == 0) {
+                            // found the last function of path
+                            // init, don't reset colors
+                            outscanreset(&scan);
+                            // bdepth and fdepth are inverted on purpose, because we are scanning toward roots
+                            // in the opposite direction
+                            // last parameter = 1 because we are coloring the path
+                            iErr = outsubtree(&scan, pparam, &i, 1, pparam->bdepth, pparam->fdepth, 1);
+                            // break; break missing because the same function can have multiple defintions in different files
+                        }
+                    }
 
-        // init, don't set color, don't reset isroot flags
-        outtreeinit(ptree, -1, 0);
+                    // the colors found are the ones printed
+                    for (i = 0; i < scan.graph.nodeno; i++)
+                        scan.graph.nodes[i]->icolor = scan.color[i];
+                }
 
-        // this is the actual output production
-        pnode = symtree_first(ptree);
-        while (iErr == 0 && pnode != NULL) {
-            // find all roots and start scanning from those nodes
-            if (pnode->isroot)
-                iErr = outsubtree(pparam, pnode, pparam->fdepth, pparam->bdepth, -1);
+                // init, don't reset colors
+                outscanreset(&scan);
 
-            pnode = symtree_next(pnode);
+                if (pparam->condense || pparam->reduce || pparam->maxnodes > 0 || pparam->pagesize > 0) {
+                    // the selected functions are marked first and printed as a graph afterwards
+                    iErr = outmarked(&scan, pparam);
+                } else if (pparam->fdepth == 0 || pparam->bdepth == 0) {
+                    // scanning in one direction only: level by level on the frozen graph
+                    iErr = outswept(&scan, pparam);
+                } else {
+                    // this is the actual output production: find all roots and start scanning from
+                    // those nodes
+                    memset(&roots, 0, sizeof(outqueue_t));
+                    iErr = outroots(&scan, &roots);
+                    if (iErr == 0)
+                        iErr = outsubtree(&scan, pparam, roots.idx, roots.nodeno, pparam->fdepth, pparam->bdepth, -1);
+                    outqueuefree(&roots);
+                }
+            }
         }
+        outscanfree(&scan);
 
         // terminate the tree output
         iErrC = outclose(ptree, pparam);
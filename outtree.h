@@ -26,10 +26,28 @@
 #define _OUTTREE_H
 
 #ifndef _ALL_IN_ONE
+#include "symgraph.h"
 #include "symtree.h"
 #include "ttreeparam.h"
 #endif // _ALL_IN_ONE
 
+typedef struct outqueue_st {
+    int *idx;   // graph indexes of the queued nodes
+    int nodeno; // number of queued nodes
+    int maxno;  // number of allocated entries
+} outqueue_t;
+
+// state of the tree scanning: the frozen graph laid out in search order from
+// the roots, with the state of each node in small arrays by graph index
+typedef struct outscan_st {
+    symgraph_t graph;
+    char *keep;     // = 0 when the node is excluded (-x option)
+    char *done;     // = 1 when node output is done
+    char *expanded; // = 1 when node subtree output is done
+    int *color;     // color for node (0 = default), copied to the tree nodes to be printed
+} outscan_t;
+
 int outtree(symtree_t *ptree, treeparam_t *pparam);
+int outexcluded(symtree_node_t *pnode, treeparam_t *pparam);
 
 #endif // #ifndef _OUTTREE_H
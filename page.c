@@ -0,0 +1,162 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "page.h"
+
+// number the nodes reached from v depth first, after the first orderno ones;
+// returns the new number. The neighbours of a node are its callees, then its
+// callers: next[] is the position of the next one to visit.
+static int pagedfs(symgraph_t *graph, const char *keep, int v, int *order, int orderno, int *page, int *stack, int *next)
+{
+    int top = 0, w, j, outno;
+
+    page[v] = 0;
+    order[orderno++] = v;
+    stack[top++] = v;
+    next[v] = 0;
+    while (top > 0) {
+        v = stack[top - 1];
+        outno = graph->childstart[v + 1] - graph->childstart[v];
+        j = next[v]++;
+        if (j < outno) {
+            w = graph->child[graph->childstart[v] + j];
+        } else if (j < outno + graph->parentstart[v + 1] - graph->parentstart[v]) {
+            w = graph->parent[graph->parentstart[v] + j - outno];
+        } else {
+            top--;
+            continue;
+        }
+        if (keep[w] && page[w] < 0) {
+            page[w] = 0;
+            order[orderno++] = w;
+            stack[top++] = w;
+            next[w] = 0;
+        }
+    }
+
+    return orderno;
+}
+
+// stubs added to page p by node v, at position i of the pages starting at
+// start: a box for each page already cut that v calls or is called from, and
+// one for each node not cut yet, as they may all end up in different pages.
+// pagestamp[q] == p once page q has its box in page p, nodestamp[w] == p once
+// node w is counted.
+static int pagestubs(symgraph_t *graph, const char *keep, int v, int p, int start, int i, const int *pos, const int *page, int *pagestamp, int *nodestamp)
+{
+    int *adjstart, *adj;
+    int stubno = 0, j, k, w;
+
+    // callees, then callers
+    for (j = 0; j < 2; j++) {
+        adjstart = j == 0 ? graph->childstart : graph->parentstart;
+        adj = j == 0 ? graph->child : graph->parent;
+        for (k = adjstart[v]; k < adjstart[v + 1]; k++) {
+            w = adj[k];
+            if (!keep[w])
+                continue;
+            if (pos[w] < start) {
+                if (pagestamp[page[w]] != p) {
+                    pagestamp[page[w]] = p;
+                    stubno++;
+                }
+            } else if (pos[w] > i && nodestamp[w] != p) {
+                nodestamp[w] = p;
+                stubno++;
+            }
+        }
+    }
+
+    return stubno;
+}
+
+// cut the numbered nodes in pages: each takes the next nodes while they fit
+// in pagesize together with the stubs of its calls to the other pages; a node
+// too connected to fit even alone gets a page of its own
+static int pagecut(symgraph_t *graph, const char *keep, const int *order, int orderno, int pagesize, int *page, int *pos, int *pagestamp, int *nodestamp)
+{
+    int p = 0, start = 0, nodeno = 0, stubno = 0;
+    int i, v, added, inner;
+
+    for (i = 0; i < graph->nodeno; i++)
+        nodestamp[i] = -1;
+    for (i = 0; i < orderno; i++) {
+        pos[order[i]] = i;
+        pagestamp[i] = -1;
+    }
+
+    for (i = 0; i < orderno; i++) {
+        v = order[i];
+        inner = nodestamp[v] == p; // counted as a stub of the page, now in it
+        added = pagestubs(graph, keep, v, p, start, i, pos, page, pagestamp, nodestamp);
+        if (nodeno > 0 && nodeno + 1 + stubno + added - inner > pagesize) {
+            // the stamps of page p left by v are not looked at any more
+            p++;
+            start = i;
+            nodeno = 0;
+            stubno = 0;
+            inner = 0;
+            added = pagestubs(graph, keep, v, p, start, i, pos, page, pagestamp, nodestamp);
+        }
+        stubno += added - inner;
+        page[v] = p;
+        nodeno++;
+    }
+
+    return orderno > 0 ? p + 1 : 0;
+}
+
+int page_split(symgraph_t *graph, const char *keep, const int *roots, int rootno, int pagesize, int *order, int *page)
+{
+    int *stack, *next, *stamp;
+    int i, orderno = 0, pageno, runsize;
+
+    stack = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    next = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    stamp = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    if (stack == NULL || next == NULL || stamp == NULL) {
+        printf("\nMemory allocation error\n");
+        free(stack);
+        free(next);
+        free(stamp);
+        return -1;
+    }
+
+    for (i = 0; i < graph->nodeno; i++)
+        page[i] = -1;
+    for (i = 0; i < rootno; i++)
+        if (keep[roots[i]] && page[roots[i]] < 0)
+            orderno = pagedfs(graph, keep, roots[i], order, orderno, page, stack, next);
+    // nodes not connected to the roots (none, unless the roots were excluded)
+    for (i = 0; i < graph->nodeno; i++)
+        if (keep[i] && page[i] < 0)
+            orderno = pagedfs(graph, keep, i, order, orderno, page, stack, next);
+
+    // a page has at most a stub for each other page: the fewest equal runs
+    // that fit with as many stubs, if there are any; else each page is cut
+    // where its own stubs say, reusing the arrays of the search
+    for (pageno = 1; pageno <= orderno; pageno++)
+        if ((orderno + pageno - 1) / pageno + pageno - 1 <= pagesize)
+            break;
+    if (pageno <= orderno) {
+        runsize = (orderno + pageno - 1) / pageno;
+        for (i = 0; i < orderno; i++)
+            page[order[i]] = i / runsize;
+        pageno = (orderno + runsize - 1) / runsize;
+    } else {
+        pageno = pagecut(graph, keep, order, orderno, pagesize, page, stack, stamp, next);
+    }
+
+    free(stack);
+    free(next);
+    free(stamp);
+
+    return pageno;
+}
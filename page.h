@@ -0,0 +1,25 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _PAGE_H
+#define _PAGE_H
+
+#include "symgraph.h"
+
+// Split the nodes with keep[i] != 0 into pages of at most pagesize nodes,
+// counting a stub for each other page a page calls or is called from. The
+// nodes are numbered depth first from the roots, following the calls and then
+// the callers, so that a page holds whole subtrees of the call tree as far as
+// they fit, and cut in the fewest equal runs that fit with a stub for every
+// other page. When no number of pages fits that way, each page takes the next
+// nodes while they fit with the stubs of their calls, and a node whose calls
+// lead to too many pages gets a page of its own, where the stubs have to be
+// shared. order[] receives the kept nodes page by page, page[i] the page of
+// node i (-1 if not kept). Returns the number of pages, or -1 on error.
+int page_split(symgraph_t *graph, const char *keep, const int *roots, int rootno, int pagesize, int *order, int *page);
+
+#endif //  _PAGE_H
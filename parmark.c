@@ -0,0 +1,588 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef TT_NOTHREADS
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#endif // TT_NOTHREADS
+
+#include "dobfs.h"
+#include "parmark.h"
+
+#define KEPT(keep, i) (!(keep) || (keep)[i])
+
+// single threaded marking, also used when threads are not available
+static int seqmark(symgraph_t *graph, const char *keep, const int *roots, int rootno, int forward, char *mark)
+{
+    int *dist;
+    int i, iErr;
+
+    dist = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    if (!dist) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+
+    iErr = dobfs(graph, keep, roots, rootno, forward, -1, dist);
+    for (i = 0; iErr == 0 && i < graph->nodeno; i++)
+        mark[i] = dist[i] >= 0;
+
+    free(dist);
+
+    return iErr;
+}
+
+#ifndef TT_NOTHREADS
+
+// Work-stealing marking: a node is claimed by the worker that flips its
+// visited mark, so it is expanded once. Claimed nodes go to a private stack of
+// the worker (no locking, depth first); from time to time the oldest of them,
+// usually the largest pieces of work, are moved to the worker's deque, where
+// idle workers steal them from.
+
+#define PARMARK_BATCH 64 // nodes moved at once from the private stack to the deque
+
+typedef struct pardeque {
+    pthread_mutex_t lock;
+    int *items; // ring buffer
+    int cap;
+    int head;   // oldest item, taken by thieves
+    int size;
+} pardeque_t;
+
+typedef struct parctx {
+    const char *keep;
+    int *start;
+    int *adj;
+    int jobs;
+    atomic_uchar *visited;
+    atomic_long pending; // claimed nodes not yet expanded
+    atomic_int err;
+    pardeque_t *deques;
+} parctx_t;
+
+typedef struct parworker {
+    parctx_t *ctx;
+    int id;
+} parworker_t;
+
+static int dq_push(pardeque_t *dq, int v)
+{
+    int *items;
+    int i;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->size == dq->cap) {
+        items = (int *)malloc(2 * dq->cap * sizeof(int));
+        if (!items) {
+            pthread_mutex_unlock(&dq->lock);
+            return -1;
+        }
+        for (i = 0; i < dq->size; i++)
+            items[i] = dq->items[(dq->head + i) % dq->cap];
+        free(dq->items);
+        dq->items = items;
+        dq->cap *= 2;
+        dq->head = 0;
+    }
+    dq->items[(dq->head + dq->size) % dq->cap] = v;
+    dq->size++;
+    pthread_mutex_unlock(&dq->lock);
+
+    return 0;
+}
+
+// move the n oldest items of a private stack to the deque, unless the deque
+// still has enough work or is busy
+static int dq_publish(pardeque_t *dq, int *stack, int *stackno, int n)
+{
+    int *items;
+    int i, cap;
+
+    if (pthread_mutex_trylock(&dq->lock) != 0)
+        return 0;
+    if (dq->size >= n) {
+        pthread_mutex_unlock(&dq->lock);
+        return 0;
+    }
+    if (dq->size + n > dq->cap) {
+        for (cap = dq->cap; cap < dq->size + n; cap *= 2)
+            ;
+        items = (int *)malloc(cap * sizeof(int));
+        if (!items) {
+            pthread_mutex_unlock(&dq->lock);
+            return -1;
+        }
+        for (i = 0; i < dq->size; i++)
+            items[i] = dq->items[(dq->head + i) % dq->cap];
+        free(dq->items);
+        dq->items = items;
+        dq->cap = cap;
+        dq->head = 0;
+    }
+    for (i = 0; i < n; i++)
+        dq->items[(dq->head + dq->size + i) % dq->cap] = stack[i];
+    dq->size += n;
+    pthread_mutex_unlock(&dq->lock);
+
+    *stackno -= n;
+    memmove(stack, stack + n, *stackno * sizeof(int));
+
+    return 0;
+}
+
+// take the newest item (owner side)
+static int dq_pop(pardeque_t *dq, int *v)
+{
+    int found = 0;
+
+    pthread_mutex_lock(&dq->lock);
+    if (dq->size > 0) {
+        dq->size--;
+        *v = dq->items[(dq->head + dq->size) % dq->cap];
+        found = 1;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return found;
+}
+
+// take the oldest item (thief side)
+static int dq_steal(pardeque_t *dq, int *v)
+{
+    int found = 0;
+
+    if (pthread_mutex_trylock(&dq->lock) != 0)
+        return 0; // busy, try another victim
+    if (dq->size > 0) {
+        *v = dq->items[dq->head];
+        dq->head = (dq->head + 1) % dq->cap;
+        dq->size--;
+        found = 1;
+    }
+    pthread_mutex_unlock(&dq->lock);
+
+    return found;
+}
+
+static void *parwork(void *arg)
+{
+    parworker_t *worker = (parworker_t *)arg;
+    parctx_t *ctx = worker->ctx;
+    pardeque_t *self = &ctx->deques[worker->id];
+    int *stack, *grown;
+    int stackno = 0, stackcap = 4 * PARMARK_BATCH;
+    int i, j, v, w, found;
+    unsigned long expanded = 0;
+
+    stack = (int *)malloc(stackcap * sizeof(int));
+    if (!stack) {
+        atomic_store(&ctx->err, 1);
+        return NULL; // the other workers will steal the work of this one
+    }
+
+    for (;;) {
+        if (stackno > 0) {
+            v = stack[--stackno];
+        } else {
+            found = dq_pop(self, &v);
+            for (i = 1; !found && i < ctx->jobs; i++)
+                found = dq_steal(&ctx->deques[(worker->id + i) % ctx->jobs], &v);
+
+            if (!found) {
+                if (atomic_load(&ctx->pending) == 0)
+                    break;
+                sched_yield();
+                continue;
+            }
+        }
+
+        for (j = ctx->start[v]; j < ctx->start[v + 1]; j++) {
+            w = ctx->adj[j];
+            // plain load first: most nodes are already visited and the exchange locks the bus
+            if (KEPT(ctx->keep, w) && !atomic_load_explicit(&ctx->visited[w], memory_order_relaxed)
+                && !atomic_exchange_explicit(&ctx->visited[w], 1, memory_order_relaxed)) {
+                atomic_fetch_add(&ctx->pending, 1);
+                if (stackno == stackcap) {
+                    grown = (int *)realloc(stack, 2 * stackcap * sizeof(int));
+                    if (!grown) {
+                        atomic_store(&ctx->err, 1);
+                        atomic_fetch_sub(&ctx->pending, 1);
+                        continue;
+                    }
+                    stack = grown;
+                    stackcap *= 2;
+                }
+                stack[stackno++] = w;
+            }
+        }
+        atomic_fetch_sub(&ctx->pending, 1);
+
+        // share some work when there is enough of it
+        if (ctx->jobs > 1 && stackno >= 2 * PARMARK_BATCH && !(++expanded % PARMARK_BATCH))
+            if (dq_publish(self, stack, &stackno, PARMARK_BATCH) != 0)
+                atomic_store(&ctx->err, 1);
+    }
+
+    free(stack);
+
+    return NULL;
+}
+
+static int threadmark(symgraph_t *graph, const char *keep, const int *roots, int rootno, int forward, int jobs, char *mark)
+{
+    parctx_t ctx;
+    parworker_t workers[PARMARK_MAXJOBS];
+    pthread_t threads[PARMARK_MAXJOBS];
+    int started = 1;
+    int iErr = 0;
+    int i, r;
+
+    memset(&ctx, 0, sizeof(parctx_t));
+    ctx.keep = keep;
+    ctx.start = forward ? graph->childstart : graph->parentstart;
+    ctx.adj = forward ? graph->child : graph->parent;
+    ctx.jobs = jobs;
+    atomic_init(&ctx.pending, 0);
+    atomic_init(&ctx.err, 0);
+
+    ctx.visited = (atomic_uchar *)malloc((graph->nodeno + 1) * sizeof(atomic_uchar));
+    ctx.deques = (pardeque_t *)calloc(jobs, sizeof(pardeque_t));
+    if (!ctx.visited || !ctx.deques) {
+        free(ctx.visited);
+        free(ctx.deques);
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+    for (i = 0; i < graph->nodeno; i++)
+        atomic_init(&ctx.visited[i], 0);
+    for (i = 0; i < jobs; i++) {
+        pthread_mutex_init(&ctx.deques[i].lock, NULL);
+        ctx.deques[i].cap = 1024;
+        ctx.deques[i].items = (int *)malloc(ctx.deques[i].cap * sizeof(int));
+        if (!ctx.deques[i].items)
+            iErr = -1;
+    }
+
+    // deal the roots out to the workers
+    for (i = 0; iErr == 0 && i < rootno; i++) {
+        r = roots[i];
+        if (KEPT(keep, r) && !atomic_exchange(&ctx.visited[r], 1)) {
+            atomic_fetch_add(&ctx.pending, 1);
+            iErr = dq_push(&ctx.deques[i % jobs], r);
+        }
+    }
+
+    if (iErr == 0) {
+        for (i = 0; i < jobs; i++) {
+            workers[i].ctx = &ctx;
+            workers[i].id = i;
+        }
+        // the calling thread is worker 0
+        for (; started < jobs; started++)
+            if (pthread_create(&threads[started], NULL, parwork, &workers[started]) != 0)
+                break;
+        parwork(&workers[0]);
+        for (i = 1; i < started; i++)
+            pthread_join(threads[i], NULL);
+
+        if (atomic_load(&ctx.err))
+            iErr = -1;
+        for (i = 0; i < graph->nodeno; i++)
+            mark[i] = (char)atomic_load_explicit(&ctx.visited[i], memory_order_relaxed);
+    }
+
+    if (iErr != 0)
+        printf("\nMemory allocation error\n");
+
+    for (i = 0; i < jobs; i++) {
+        pthread_mutex_destroy(&ctx.deques[i].lock);
+        free(ctx.deques[i].items);
+    }
+    free(ctx.deques);
+    free(ctx.visited);
+
+    return iErr;
+}
+
+// Level synchronous breadth first search: the workers expand each level
+// together, as dobfs() does alone, taking chunks of the frontier (top-down
+// steps) or of all the nodes (bottom-up steps) from a shared counter, and wait
+// for each other at a barrier between the levels. In a top-down step a node
+// reached from several workers gets its distance from the first one setting
+// it; the distance is the same whichever worker that is.
+
+#define PARDIST_CHUNK 256 // nodes taken at once from the shared counter
+#define PARDIST_BUF 1024  // nodes of the next frontier collected before copying them
+
+typedef struct parbarrier {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int jobs;
+    int count;           // workers waiting
+    unsigned long round; // barriers passed
+} parbarrier_t;
+
+typedef struct pardistctx {
+    const char *keep;
+    int nodeno;
+    int *outstart;
+    int *out;
+    int *instart;
+    int *in;
+    int maxdepth;
+    atomic_int *dist;
+    int *cur;             // frontier
+    int *next;            // next frontier
+    int curno;
+    atomic_int nextno;
+    atomic_int chunk;     // first node of the next chunk of the step
+    atomic_long stepedges; // edges leaving the next frontier
+    long frontedges;       // edges leaving the frontier
+    long restedges;        // edges leaving the nodes not reached yet
+    int level;
+    int bottomup;
+    int done;
+    parbarrier_t barrier;
+} pardistctx_t;
+
+typedef struct pardistworker {
+    pardistctx_t *ctx;
+    int id;
+} pardistworker_t;
+
+static void parbarrier_wait(parbarrier_t *b)
+{
+    unsigned long round;
+
+    pthread_mutex_lock(&b->lock);
+    round = b->round;
+    if (++b->count >= b->jobs) {
+        b->count = 0;
+        b->round++;
+        pthread_cond_broadcast(&b->cond);
+    } else {
+        while (round == b->round)
+            pthread_cond_wait(&b->cond, &b->lock);
+    }
+    pthread_mutex_unlock(&b->lock);
+}
+
+// set up the next level (run by worker 0 alone, between two barriers)
+static void pardiststep(pardistctx_t *ctx, int first)
+{
+    int *swap;
+
+    if (!first) {
+        ctx->frontedges = atomic_load(&ctx->stepedges);
+        ctx->restedges -= ctx->frontedges;
+        swap = ctx->cur;
+        ctx->cur = ctx->next;
+        ctx->next = swap;
+        ctx->curno = atomic_load(&ctx->nextno);
+        ctx->level++;
+    }
+
+    ctx->done = ctx->curno == 0 || (ctx->maxdepth >= 0 && ctx->level >= ctx->maxdepth);
+    if (!ctx->bottomup && ctx->frontedges > ctx->restedges / DOBFS_ALPHA)
+        ctx->bottomup = 1;
+    else if (ctx->bottomup && ctx->curno < ctx->nodeno / DOBFS_BETA)
+        ctx->bottomup = 0;
+
+    atomic_store(&ctx->nextno, 0);
+    atomic_store(&ctx->chunk, 0);
+    atomic_store(&ctx->stepedges, 0);
+}
+
+// add w to the next frontier, through the buffer of the worker
+static void pardistadd(pardistctx_t *ctx, int *buf, int *bufno, long *edges, int w)
+{
+    int k;
+
+    buf[(*bufno)++] = w;
+    *edges += ctx->outstart[w + 1] - ctx->outstart[w];
+    if (*bufno == PARDIST_BUF) {
+        k = atomic_fetch_add(&ctx->nextno, *bufno);
+        memcpy(ctx->next + k, buf, *bufno * sizeof(int));
+        *bufno = 0;
+    }
+}
+
+static void *pardistwork(void *arg)
+{
+    pardistworker_t *worker = (pardistworker_t *)arg;
+    pardistctx_t *ctx = worker->ctx;
+    atomic_int *dist = ctx->dist;
+    int buf[PARDIST_BUF];
+    int bufno = 0;
+    int i, j, k, end, total, v, w, unset;
+    long edges;
+
+    for (;;) {
+        parbarrier_wait(&ctx->barrier);
+        if (ctx->done)
+            break;
+
+        edges = 0;
+        total = ctx->bottomup ? ctx->nodeno : ctx->curno;
+        while ((i = atomic_fetch_add(&ctx->chunk, PARDIST_CHUNK)) < total) {
+            end = i + PARDIST_CHUNK < total ? i + PARDIST_CHUNK : total;
+            for (; i < end; i++) {
+                if (ctx->bottomup) {
+                    // only this worker sets the distance of w in this step
+                    w = i;
+                    if (!KEPT(ctx->keep, w) || atomic_load_explicit(&dist[w], memory_order_relaxed) >= 0)
+                        continue;
+                    for (j = ctx->instart[w]; j < ctx->instart[w + 1]; j++) {
+                        if (atomic_load_explicit(&dist[ctx->in[j]], memory_order_relaxed) == ctx->level) {
+                            atomic_store_explicit(&dist[w], ctx->level + 1, memory_order_relaxed);
+                            pardistadd(ctx, buf, &bufno, &edges, w);
+                            break;
+                        }
+                    }
+                } else {
+                    v = ctx->cur[i];
+                    for (j = ctx->outstart[v]; j < ctx->outstart[v + 1]; j++) {
+                        w = ctx->out[j];
+                        unset = -1;
+                        // plain load first: most nodes are already reached and the exchange locks the bus
+                        if (KEPT(ctx->keep, w) && atomic_load_explicit(&dist[w], memory_order_relaxed) < 0
+                            && atomic_compare_exchange_strong_explicit(&dist[w], &unset, ctx->level + 1,
+                                                                       memory_order_relaxed, memory_order_relaxed))
+                            pardistadd(ctx, buf, &bufno, &edges, w);
+                    }
+                }
+            }
+        }
+        if (bufno > 0) {
+            k = atomic_fetch_add(&ctx->nextno, bufno);
+            memcpy(ctx->next + k, buf, bufno * sizeof(int));
+            bufno = 0;
+        }
+        atomic_fetch_add(&ctx->stepedges, edges);
+
+        parbarrier_wait(&ctx->barrier);
+        if (worker->id == 0)
+            pardiststep(ctx, 0);
+    }
+
+    return NULL;
+}
+
+static int threaddist(symgraph_t *graph, const char *keep, const int *src, int srcno, int forward, int maxdepth, int jobs,
+                      int *dist)
+{
+    pardistctx_t ctx;
+    pardistworker_t workers[PARMARK_MAXJOBS];
+    pthread_t threads[PARMARK_MAXJOBS];
+    long alledges = 0;
+    int started = 1;
+    int i, v;
+
+    memset(&ctx, 0, sizeof(pardistctx_t));
+    ctx.keep = keep;
+    ctx.nodeno = graph->nodeno;
+    ctx.outstart = forward ? graph->childstart : graph->parentstart;
+    ctx.out = forward ? graph->child : graph->parent;
+    ctx.instart = forward ? graph->parentstart : graph->childstart;
+    ctx.in = forward ? graph->parent : graph->child;
+    ctx.maxdepth = maxdepth;
+
+    ctx.dist = (atomic_int *)malloc((graph->nodeno + 1) * sizeof(atomic_int));
+    ctx.cur = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    ctx.next = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    if (!ctx.dist || !ctx.cur || !ctx.next) {
+        free(ctx.dist);
+        free(ctx.cur);
+        free(ctx.next);
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+
+    for (i = 0; i < graph->nodeno; i++) {
+        atomic_init(&ctx.dist[i], -1);
+        if (KEPT(keep, i))
+            alledges += ctx.outstart[i + 1] - ctx.outstart[i];
+    }
+    for (i = 0; i < srcno; i++) {
+        v = src[i];
+        if (KEPT(keep, v) && atomic_load(&ctx.dist[v]) < 0) {
+            atomic_store(&ctx.dist[v], 0);
+            ctx.cur[ctx.curno++] = v;
+            ctx.frontedges += ctx.outstart[v + 1] - ctx.outstart[v];
+        }
+    }
+    ctx.restedges = alledges - ctx.frontedges;
+    pardiststep(&ctx, 1);
+
+    pthread_mutex_init(&ctx.barrier.lock, NULL);
+    pthread_cond_init(&ctx.barrier.cond, NULL);
+    ctx.barrier.jobs = jobs;
+    for (i = 0; i < jobs; i++) {
+        workers[i].ctx = &ctx;
+        workers[i].id = i;
+    }
+    // the calling thread is worker 0
+    for (; started < jobs; started++)
+        if (pthread_create(&threads[started], NULL, pardistwork, &workers[started]) != 0)
+            break;
+    pthread_mutex_lock(&ctx.barrier.lock);
+    ctx.barrier.jobs = started; // the workers not started do not wait
+    pthread_mutex_unlock(&ctx.barrier.lock);
+    pardistwork(&workers[0]);
+    for (i = 1; i < started; i++)
+        pthread_join(threads[i], NULL);
+
+    for (i = 0; i < graph->nodeno; i++)
+        dist[i] = atomic_load_explicit(&ctx.dist[i], memory_order_relaxed);
+
+    pthread_mutex_destroy(&ctx.barrier.lock);
+    pthread_cond_destroy(&ctx.barrier.cond);
+    free(ctx.dist);
+    free(ctx.cur);
+    free(ctx.next);
+
+    return 0;
+}
+
+#endif // TT_NOTHREADS
+
+// Mark every node reachable from the roots (roots included) following the
+// callees (forward != 0) or the callers. Nodes with keep[i] == 0 are neither
+// marked nor crossed. The result does not depend on the number of jobs.
+int parmark(symgraph_t *graph, const char *keep, const int *roots, int rootno, int forward, int jobs, char *mark)
+{
+#ifndef TT_NOTHREADS
+    if (jobs > PARMARK_MAXJOBS)
+        jobs = PARMARK_MAXJOBS;
+    if (jobs > 1)
+        return threadmark(graph, keep, roots, rootno, forward, jobs, mark);
+#endif // TT_NOTHREADS
+
+    return seqmark(graph, keep, roots, rootno, forward, mark);
+}
+
+// dist[i] = number of calls from the nearest source to node i following the
+// callees (forward != 0) or the callers, -1 if not reached within maxdepth
+// (-1 = no limit), as dobfs() but computed by jobs threads. Nodes with
+// keep[i] == 0 are neither reached nor crossed.
+int pardist(symgraph_t *graph, const char *keep, const int *src, int srcno, int forward, int maxdepth, int jobs, int *dist)
+{
+#ifndef TT_NOTHREADS
+    if (jobs > PARMARK_MAXJOBS)
+        jobs = PARMARK_MAXJOBS;
+    if (jobs > 1)
+        return threaddist(graph, keep, src, srcno, forward, maxdepth, jobs, dist);
+#endif // TT_NOTHREADS
+
+    return dobfs(graph, keep, src, srcno, forward, maxdepth, dist);
+}
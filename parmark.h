@@ -0,0 +1,18 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _PAR_MARK_H
+#define _PAR_MARK_H
+
+#include "symgraph.h"
+
+#define PARMARK_MAXJOBS 64 // maximum number of worker threads
+
+int parmark(symgraph_t *graph, const char *keep, const int *roots, int rootno, int forward, int jobs, char *mark);
+int pardist(symgraph_t *graph, const char *keep, const int *src, int srcno, int forward, int maxdepth, int jobs, int *dist);
+
+#endif //  _PAR_MARK_H
@@ -0,0 +1,121 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "profile.h"
+
+#define MAXLINEP 65536 // maximum length of a line in the profile file
+
+// add samples to every call from a definition of caller to a definition of
+// callee, returning 0 if there is no such call
+static int addcall(profile_t *prof, symtree_t *ptree, symgraph_t *graph, char *caller, char *callee, long samples)
+{
+    symtree_node_t *pfrom;
+    int k, found = 0;
+
+    for (pfrom = symtree_find_first(ptree, caller); pfrom && strcmp(pfrom->funname, caller) == 0; pfrom = symtree_next(pfrom))
+        for (k = graph->childstart[pfrom->idx]; k < graph->childstart[pfrom->idx + 1]; k++)
+            if (strcmp(graph->nodes[graph->child[k]]->funname, callee) == 0) {
+                prof->weight[k] += samples;
+                found = 1;
+            }
+
+    return found;
+}
+
+// Read the profile file in one pass, accepting two line formats:
+// - "caller callee samples", e.g. from a gprof call graph;
+// - "frame;frame;...;frame samples", the folded stacks made from perf script
+//   output, where every pair of adjacent frames is a call.
+int profile_load(profile_t *prof, symtree_t *ptree, symgraph_t *graph, const char *filename)
+{
+    int iErr = 0;
+    FILE *filep;
+    char *sLine;
+    char *tok[4];
+    char *caller, *callee, *next, *end;
+    long samples;
+    int n, c;
+
+    memset(prof, 0, sizeof(profile_t));
+    prof->weight = (long *)calloc(graph->childstart[graph->nodeno] + 1, sizeof(long));
+    sLine = (char *)malloc(MAXLINEP);
+    if (prof->weight == NULL || sLine == NULL) {
+        printf("\nMemory allocation error\n");
+        free(sLine);
+        profile_free(prof);
+        return -1;
+    }
+
+    filep = fopen(filename, "r");
+    if (filep == NULL) {
+        printf("\nError while opening profile file\n");
+        free(sLine);
+        profile_free(prof);
+        return -1;
+    }
+
+    while (fgets(sLine, MAXLINEP, filep) != NULL) {
+        if (strchr(sLine, '\n') == NULL && !feof(filep)) {
+            // skip the rest of a line too long to be read
+            while ((c = fgetc(filep)) != EOF && c != '\n')
+                ;
+            printf("\nProfile line too long, ignored\n");
+            continue;
+        }
+
+        for (n = 0, next = strtok(sLine, " \t\r\n"); next != NULL && n < 4; next = strtok(NULL, " \t\r\n"))
+            tok[n++] = next;
+        if (n == 0 || tok[0][0] == '#')
+            continue;
+
+        if (n < 2 || n > 3 || (samples = strtol(tok[n - 1], &end, 10)) < 0 || *end != '\0') {
+            printf("\nInvalid profile line: %s\n", tok[0]);
+            continue;
+        }
+        prof->total += samples;
+
+        if (n == 3) {
+            if (!addcall(prof, ptree, graph, tok[0], tok[1], samples))
+                prof->unmatched++;
+        } else {
+            // folded stack, outermost frame first
+            for (caller = tok[0]; (next = strchr(caller, ';')) != NULL; caller = callee) {
+                *next = '\0';
+                callee = next + 1;
+                // the callee name ends at the next frame separator
+                next = strchr(callee, ';');
+                if (next)
+                    *next = '\0';
+                if (!addcall(prof, ptree, graph, caller, callee, samples))
+                    prof->unmatched++;
+                if (next)
+                    *next = ';';
+            }
+        }
+    }
+
+    if (fclose(filep) != 0) {
+        printf("\nError while closing profile file\n");
+        iErr = -1;
+    }
+
+    free(sLine);
+    if (iErr != 0)
+        profile_free(prof);
+
+    return iErr;
+}
+
+void profile_free(profile_t *prof)
+{
+    free(prof->weight);
+    memset(prof, 0, sizeof(profile_t));
+}
@@ -0,0 +1,27 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _PROFILE_H
+#define _PROFILE_H
+
+#include "symgraph.h"
+
+typedef struct profile profile_t;
+
+// Runtime samples of a symgraph's calls, read from a profile file and joined
+// with the graph by function name. weight[k] is the number of samples of the
+// call child[k], the calls of every definition of a name getting the samples.
+struct profile {
+    long *weight;   // samples of each call, indexed like graph->child
+    long total;     // samples read
+    long unmatched; // profiled calls not found in the graph
+};
+
+int profile_load(profile_t *prof, symtree_t *ptree, symgraph_t *graph, const char *filename);
+void profile_free(profile_t *prof);
+
+#endif //  _PROFILE_H
@@ -0,0 +1,167 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "prune.h"
+
+// ranking keys, for the comparison function
+static const int *prunedist;
+static const int *prunedeg;
+
+// nearest to the roots first, then most connected, then by index
+static int cmprank(const void *a, const void *b)
+{
+    int l = *(const int *)a;
+    int r = *(const int *)b;
+
+    if (prunedist[l] != prunedist[r])
+        return prunedist[l] - prunedist[r];
+    if (prunedeg[l] != prunedeg[r])
+        return prunedeg[r] - prunedeg[l];
+
+    return l - r;
+}
+
+// number of output nodes when the first k nodes of the ranking are kept: the
+// kept ones plus one summary node for each of them standing for pruned ones.
+// order[] is a breadth first order, so the node a pruned node was reached
+// from comes first and already has its owner.
+static int prunecost(const int *order, int orderno, const int *rank, const int *from, int k, int *owner, int *hidden)
+{
+    int i, v, stubno = 0;
+
+    for (i = 0; i < orderno; i++) {
+        v = order[i];
+        hidden[v] = 0;
+        if (rank[v] < k)
+            owner[v] = v;
+        else
+            owner[v] = from[v] >= 0 ? owner[from[v]] : -1;
+    }
+    for (i = 0; i < orderno; i++) {
+        v = order[i];
+        if (owner[v] >= 0 && owner[v] != v && hidden[owner[v]]++ == 0)
+            stubno++;
+    }
+
+    return k + stubno;
+}
+
+int prune(symgraph_t *graph, char *keep, const int *roots, int rootno, int maxnodes, int *hidden)
+{
+    int *order, *from, *dist, *deg, *rank, *owner;
+    int orderno = 0, head = 0;
+    int i, j, v, w, lo, hi, mid, selno = 0;
+    int iErr = 0;
+
+    for (i = 0; i < graph->nodeno; i++) {
+        hidden[i] = 0;
+        if (keep[i])
+            selno++;
+    }
+    if (selno <= maxnodes)
+        return 0;
+
+    order = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    from = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    dist = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    deg = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    rank = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    owner = (int *)malloc((graph->nodeno + 1) * sizeof(int));
+    if (!order || !from || !dist || !deg || !rank || !owner) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    }
+
+    if (iErr == 0) {
+        // breadth first from the roots over the kept nodes, following the calls
+        // in both directions; the degree counts the kept neighbours only
+        for (i = 0; i < graph->nodeno; i++) {
+            dist[i] = -1;
+            deg[i] = 0;
+            rank[i] = graph->nodeno;
+            if (keep[i]) {
+                for (j = graph->childstart[i]; j < graph->childstart[i + 1]; j++)
+                    deg[i] += keep[graph->child[j]] != 0;
+                for (j = graph->parentstart[i]; j < graph->parentstart[i + 1]; j++)
+                    deg[i] += keep[graph->parent[j]] != 0;
+            }
+        }
+        for (i = 0; i < rootno; i++) {
+            v = roots[i];
+            if (keep[v] && dist[v] < 0) {
+                dist[v] = 0;
+                from[v] = -1;
+                order[orderno++] = v;
+            }
+        }
+        while (head < orderno) {
+            v = order[head++];
+            for (j = graph->childstart[v]; j < graph->childstart[v + 1]; j++) {
+                w = graph->child[j];
+                if (keep[w] && dist[w] < 0) {
+                    dist[w] = dist[v] + 1;
+                    from[w] = v;
+                    order[orderno++] = w;
+                }
+            }
+            for (j = graph->parentstart[v]; j < graph->parentstart[v + 1]; j++) {
+                w = graph->parent[j];
+                if (keep[w] && dist[w] < 0) {
+                    dist[w] = dist[v] + 1;
+                    from[w] = v;
+                    order[orderno++] = w;
+                }
+            }
+        }
+        // nodes not connected to the roots (none, unless the roots were
+        // excluded) come last and are summarized by nobody
+        for (i = 0; i < graph->nodeno; i++) {
+            if (keep[i] && dist[i] < 0) {
+                dist[i] = graph->nodeno;
+                from[i] = -1;
+                order[orderno++] = i;
+            }
+        }
+
+        // the order stays breadth first: only nodes at the same distance swap
+        prunedist = dist;
+        prunedeg = deg;
+        qsort(order, orderno, sizeof(int), cmprank);
+        for (i = 0; i < orderno; i++)
+            rank[order[i]] = i;
+
+        // the cost grows with the kept nodes: each one adds itself and takes a
+        // summary node from its owner or adds its own, so search the largest fit
+        lo = 1;
+        hi = maxnodes < orderno ? maxnodes : orderno;
+        while (lo < hi) {
+            mid = lo + (hi - lo + 1) / 2;
+            if (prunecost(order, orderno, rank, from, mid, owner, hidden) <= maxnodes)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        prunecost(order, orderno, rank, from, lo, owner, hidden);
+
+        for (i = 0; i < orderno; i++)
+            if (rank[order[i]] >= lo)
+                keep[order[i]] = 0;
+    }
+
+    free(order);
+    free(from);
+    free(dist);
+    free(deg);
+    free(rank);
+    free(owner);
+
+    return iErr;
+}
@@ -0,0 +1,21 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _PRUNE_H
+#define _PRUNE_H
+
+#include "symgraph.h"
+
+// Cut the nodes with keep[i] != 0 down to at most maxnodes, counting one
+// summary node for each kept node standing for pruned ones. The nodes nearest
+// to the roots are kept, the most connected first among those at the same
+// distance; every pruned node is summarized by the kept node it was reached
+// through, and hidden[i] receives the number of pruned nodes summarized by
+// kept node i (0 for the others). keep is updated.
+int prune(symgraph_t *graph, char *keep, const int *roots, int rootno, int maxnodes, int *hidden);
+
+#endif //  _PRUNE_H
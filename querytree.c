@@ -0,0 +1,123 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef _ALL_IN_ONE
+#include "defines.h"
+#include "outtree.h"
+#include "querytree.h"
+#include "reach.h"
+#include "symgraph.h"
+#endif // _ALL_IN_ONE
+
+#define MAXLINEQ 1024 // maximum length of a line in the query file
+
+// answer one query: 1 if any definition of caller reaches any definition of callee,
+// 0 if none does, -1 if one of the functions is unknown
+static int queryone(symtree_t *ptree, reach_t *pidx, char *caller, char *callee)
+{
+    symtree_node_t *pfrom, *pto, *pfirstto;
+
+    pfrom = symtree_find_first(ptree, caller);
+    pfirstto = symtree_find_first(ptree, callee);
+    if (pfrom == NULL || pfirstto == NULL)
+        return -1;
+
+    // the same function name may be defined in several files
+    for (; pfrom && strcmp(pfrom->funname, caller) == 0; pfrom = symtree_next(pfrom))
+        for (pto = pfirstto; pto && strcmp(pto->funname, callee) == 0; pto = symtree_next(pto))
+            if (reach_query(pidx, pfrom->idx, pto->idx))
+                return 1;
+
+    return 0;
+}
+
+// answer the "does caller ever call callee" queries listed in the query file
+int querytree(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    FILE *fileq;
+    symgraph_t graph;
+    reach_t idx;
+    char sLine[MAXLINEQ];
+    char *caller, *callee;
+    char *keep;
+    int i, res;
+    long queryno = 0;
+    clock_t tstart, tbuilt;
+
+    tstart = clock();
+
+    iErr = symgraph_build(&graph, ptree);
+    if (iErr == 0)
+        iErr = symgraph_relabel(&graph, NULL, 0); // the many searches that follow get a compact layout
+    if (iErr != 0) {
+        symgraph_free(&graph);
+        return iErr;
+    }
+
+    // excluded functions (-x option) are not traversed
+    keep = (char *)malloc(graph.nodeno + 1);
+    if (keep == NULL) {
+        printf("\nMemory allocation error\n");
+        symgraph_free(&graph);
+        return -1;
+    }
+    for (i = 0; i < graph.nodeno; i++)
+        keep[i] = !outexcluded(graph.nodes[i], pparam);
+
+    iErr = reach_build(&idx, &graph, keep);
+    free(keep);
+    if (iErr != 0) {
+        symgraph_free(&graph);
+        return iErr;
+    }
+
+    tbuilt = clock();
+    if (pparam->verbose)
+        printf("\nReachability index: %d functions, %d components, built in %.3f s\n",
+            graph.nodeno, idx.scc.sccno, (double)(tbuilt - tstart) / CLOCKS_PER_SEC);
+
+    fileq = fopen(pparam->queryfile, "r");
+    if (fileq == NULL) {
+        printf("\nError while opening query file\n");
+        iErr = -1;
+    } else {
+        // one "caller callee" pair per line, answered with "caller callee yes|no|unknown"
+        while (fgets(sLine, MAXLINEQ, fileq) != NULL) {
+            caller = strtok(sLine, " \t\r\n");
+            if (caller == NULL || caller[0] == '#')
+                continue;
+            callee = strtok(NULL, " \t\r\n");
+            if (callee == NULL) {
+                printf("\nInvalid query: %s\n", caller);
+                continue;
+            }
+
+            res = queryone(ptree, &idx, caller, callee);
+            printf("%s %s %s\n", caller, callee, res > 0 ? "yes" : (res == 0 ? "no" : "unknown"));
+            queryno++;
+        }
+
+        if (fclose(fileq) != 0) {
+            printf("\nError while closing query file\n");
+            iErr = -1;
+        }
+    }
+
+    if (pparam->verbose && queryno > 0)
+        printf("%ld queries answered in %.3f s\n", queryno, (double)(clock() - tbuilt) / CLOCKS_PER_SEC);
+
+    reach_free(&idx);
+    symgraph_free(&graph);
+
+    return iErr;
+}
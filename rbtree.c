@@ -192,6 +192,27 @@ rb_node_t *rb_tree_find(rb_tree_t *tree, void *data)
     return NULL;
 }
 
+// like rb_tree_find(), but return the left-most node among those matching
+rb_node_t *rb_tree_find_first(rb_tree_t *tree, void *data)
+{
+    rb_node_t *x = tree->node;
+    rb_node_t *found = NULL;
+    int c;
+
+    while (x) {
+        c = tree->find_cmp(data, x);
+        if (c == 0) {
+            found = x;
+            x = x->left;
+        } else if (c < 1)
+            x = x->left;
+        else
+            x = x->right;
+    }
+
+    return found;
+}
+
 rb_node_t *rb_first(rb_tree_t *t)
 {
     rb_node_t *node = t->node;
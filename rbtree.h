@@ -45,6 +45,7 @@ struct rb_node {
 
 int rb_tree_add(rb_tree_t *tree, rb_node_t *node, void *data);
 rb_node_t *rb_tree_find(rb_tree_t *tree, void *data);
+rb_node_t *rb_tree_find_first(rb_tree_t *tree, void *data);
 
 rb_node_t *rb_first(rb_tree_t *t);
 rb_node_t *rb_next(rb_node_t *node);
@@ -0,0 +1,180 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "reach.h"
+
+void reach_free(reach_t *idx)
+{
+    int t;
+
+    scc_free(&idx->scc);
+    for (t = 0; t < REACH_LABELS; t++) {
+        free(idx->rank[t]);
+        free(idx->low[t]);
+    }
+    free(idx->treelow);
+    free(idx->visited);
+    free(idx->stack);
+    memset(idx, 0, sizeof(reach_t));
+}
+
+// Post-order labeling t of the condensed DAG. Odd labelings walk roots and
+// successors in the opposite order so that the intervals differ.
+static void label(reach_t *idx, int t, int *cnode, int *cpos)
+{
+    scc_t *scc = &idx->scc;
+    int *rank = idx->rank[t];
+    int *low = idx->low[t];
+    int counter = 0, csp, r, c, v, w, p;
+
+    for (c = 0; c < scc->sccno; c++)
+        rank[c] = -1;
+
+    for (r = 0; r < scc->sccno; r++) {
+        c = (t & 1) ? r : scc->sccno - 1 - r; // sources have the highest indexes
+        if (rank[c] != -1)
+            continue;
+
+        csp = 0;
+        rank[c] = -2; // entered
+        low[c] = INT_MAX;
+        if (t == 0)
+            idx->treelow[c] = counter;
+        cnode[csp] = c;
+        cpos[csp++] = 0;
+
+        while (csp > 0) {
+            v = cnode[csp - 1];
+            p = cpos[csp - 1]++;
+            if (p < scc->succstart[v + 1] - scc->succstart[v]) {
+                w = (t & 1) ? scc->succ[scc->succstart[v + 1] - 1 - p] : scc->succ[scc->succstart[v] + p];
+                if (rank[w] == -1) {
+                    rank[w] = -2;
+                    low[w] = INT_MAX;
+                    if (t == 0)
+                        idx->treelow[w] = counter;
+                    cnode[csp] = w;
+                    cpos[csp++] = 0;
+                } else if (low[w] < low[v]) {
+                    // a DAG has no back edges: w is already finished
+                    low[v] = low[w];
+                }
+            } else {
+                rank[v] = counter++;
+                if (rank[v] < low[v])
+                    low[v] = rank[v];
+                csp--;
+                if (csp > 0 && low[v] < low[cnode[csp - 1]])
+                    low[cnode[csp - 1]] = low[v];
+            }
+        }
+    }
+}
+
+int reach_build(reach_t *idx, symgraph_t *graph, const char *keep)
+{
+    int *cnode = NULL, *cpos = NULL;
+    int t, n;
+
+    memset(idx, 0, sizeof(reach_t));
+
+    if (scc_build(&idx->scc, graph, keep) != 0)
+        return -1;
+
+    n = idx->scc.sccno;
+    for (t = 0; t < REACH_LABELS; t++) {
+        idx->rank[t] = (int *)malloc((n + 1) * sizeof(int));
+        idx->low[t] = (int *)malloc((n + 1) * sizeof(int));
+        if (!idx->rank[t] || !idx->low[t])
+            goto err;
+    }
+    idx->treelow = (int *)malloc((n + 1) * sizeof(int));
+    idx->visited = (int *)calloc(n + 1, sizeof(int));
+    idx->stack = (int *)malloc((n + 1) * sizeof(int));
+    cnode = (int *)malloc((n + 1) * sizeof(int));
+    cpos = (int *)malloc((n + 1) * sizeof(int));
+    if (!idx->treelow || !idx->visited || !idx->stack || !cnode || !cpos)
+        goto err;
+
+    for (t = 0; t < REACH_LABELS; t++)
+        label(idx, t, cnode, cpos);
+
+    free(cnode);
+    free(cpos);
+
+    return 0;
+
+err:
+    printf("\nMemory allocation error\n");
+    free(cnode);
+    free(cpos);
+    reach_free(idx);
+
+    return -1;
+}
+
+// 1 if the labels of a contain those of b in every labeling
+static int contains(reach_t *idx, int a, int b)
+{
+    int t;
+
+    for (t = 0; t < REACH_LABELS; t++)
+        if (idx->low[t][a] > idx->low[t][b] || idx->rank[t][b] > idx->rank[t][a])
+            return 0;
+
+    return 1;
+}
+
+// 1 if b is in the DFS subtree of a in the first labeling
+static int treecontains(reach_t *idx, int a, int b)
+{
+    return idx->treelow[a] <= idx->rank[0][b] && idx->rank[0][b] <= idx->rank[0][a];
+}
+
+// 1 if graph node from calls graph node to, directly or indirectly
+int reach_query(reach_t *idx, int from, int to)
+{
+    scc_t *scc = &idx->scc;
+    int a = scc->comp[from];
+    int b = scc->comp[to];
+    int sp = 0, v, w, j;
+
+    if (a < 0 || b < 0)
+        return 0;
+    if (a == b)
+        return scc->recursive[a];
+    if (b > a || !contains(idx, a, b))
+        return 0;
+    if (treecontains(idx, a, b))
+        return 1;
+
+    // undecided by the labels: search the DAG, skipping components whose labels exclude b
+    idx->stamp++;
+    idx->visited[a] = idx->stamp;
+    idx->stack[sp++] = a;
+    while (sp > 0) {
+        v = idx->stack[--sp];
+        for (j = scc->succstart[v]; j < scc->succstart[v + 1]; j++) {
+            w = scc->succ[j];
+            if (w == b)
+                return 1;
+            if (idx->visited[w] == idx->stamp || w < b || !contains(idx, w, b))
+                continue;
+            if (treecontains(idx, w, b))
+                return 1;
+            idx->visited[w] = idx->stamp;
+            idx->stack[sp++] = w;
+        }
+    }
+
+    return 0;
+}
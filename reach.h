@@ -0,0 +1,39 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _REACH_H
+#define _REACH_H
+
+#include "scc.h"
+#include "symgraph.h"
+
+#define REACH_LABELS 2 // number of interval labelings
+
+typedef struct reach reach_t;
+
+// Reachability index over the condensed DAG of a symgraph.
+// Each labeling is a post-order numbering of a DFS over the DAG; low[] is the
+// minimum rank reachable from a component, so if a reaches b then
+// [low(b), rank(b)] lies within [low(a), rank(a)] in every labeling (exact
+// negative answers). treelow[] of the first labeling delimits the DFS subtree
+// of a component (exact positive answers). The rest is settled by a DFS
+// pruned with the same labels.
+struct reach {
+    scc_t scc;
+    int *rank[REACH_LABELS];
+    int *low[REACH_LABELS];
+    int *treelow;
+    int *visited; // visit stamps for the fallback search
+    int *stack;
+    int stamp;
+};
+
+int reach_build(reach_t *idx, symgraph_t *graph, const char *keep);
+void reach_free(reach_t *idx);
+int reach_query(reach_t *idx, int from, int to);
+
+#endif //  _REACH_H
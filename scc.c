@@ -0,0 +1,235 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "scc.h"
+
+#define KEPT(keep, i) (!(keep) || (keep)[i])
+
+typedef unsigned long bitword_t;
+#define WORDBITS (sizeof(bitword_t) * CHAR_BIT)
+#define BITSET(row, i) ((row)[(i) / WORDBITS] |= (bitword_t)1 << ((i) % WORDBITS))
+#define BITTEST(row, i) (((row)[(i) / WORDBITS] >> ((i) % WORDBITS)) & 1)
+
+void scc_free(scc_t *scc)
+{
+    free(scc->comp);
+    free(scc->memberstart);
+    free(scc->member);
+    free(scc->succstart);
+    free(scc->succ);
+    free(scc->recursive);
+    memset(scc, 0, sizeof(scc_t));
+}
+
+// Iterative Tarjan: the recursion is replaced by an explicit stack of
+// (node, next child offset) pairs, so deep call chains cannot overflow the
+// C stack. Only nodes with keep[i] != 0 are considered (all if keep == NULL).
+static int tarjan(scc_t *scc, symgraph_t *graph, const char *keep)
+{
+    int n = graph->nodeno;
+    int *index, *low, *stack, *cnode, *cpos;
+    char *onstack;
+    int counter = 0, sp = 0, csp = 0;
+    int r, v, w;
+
+    index = (int *)malloc((n + 1) * sizeof(int));
+    low = (int *)malloc((n + 1) * sizeof(int));
+    stack = (int *)malloc((n + 1) * sizeof(int));
+    cnode = (int *)malloc((n + 1) * sizeof(int));
+    cpos = (int *)malloc((n + 1) * sizeof(int));
+    onstack = (char *)calloc(n + 1, sizeof(char));
+    if (!index || !low || !stack || !cnode || !cpos || !onstack) {
+        free(index);
+        free(low);
+        free(stack);
+        free(cnode);
+        free(cpos);
+        free(onstack);
+        return -1;
+    }
+
+    for (v = 0; v < n; v++) {
+        index[v] = -1;
+        scc->comp[v] = -1;
+    }
+
+    for (r = 0; r < n; r++) {
+        if (!KEPT(keep, r) || index[r] >= 0)
+            continue;
+
+        index[r] = low[r] = counter++;
+        stack[sp++] = r;
+        onstack[r] = 1;
+        cnode[csp] = r;
+        cpos[csp++] = graph->childstart[r];
+
+        while (csp > 0) {
+            v = cnode[csp - 1];
+            if (cpos[csp - 1] < graph->childstart[v + 1]) {
+                w = graph->child[cpos[csp - 1]++];
+                if (!KEPT(keep, w))
+                    continue;
+                if (index[w] < 0) {
+                    // descend
+                    index[w] = low[w] = counter++;
+                    stack[sp++] = w;
+                    onstack[w] = 1;
+                    cnode[csp] = w;
+                    cpos[csp++] = graph->childstart[w];
+                } else if (onstack[w] && index[w] < low[v]) {
+                    low[v] = index[w];
+                }
+            } else {
+                // all callees done: v is the root of a component if nothing below reaches higher
+                csp--;
+                if (low[v] == index[v]) {
+                    do {
+                        w = stack[--sp];
+                        onstack[w] = 0;
+                        scc->comp[w] = scc->sccno;
+                    } while (w != v);
+                    scc->sccno++;
+                }
+                if (csp > 0 && low[v] < low[cnode[csp - 1]])
+                    low[cnode[csp - 1]] = low[v];
+            }
+        }
+    }
+
+    free(index);
+    free(low);
+    free(stack);
+    free(cnode);
+    free(cpos);
+    free(onstack);
+
+    return 0;
+}
+
+int scc_build(scc_t *scc, symgraph_t *graph, const char *keep)
+{
+    int n = graph->nodeno;
+    int *stamp = NULL;
+    int i, j, c, d, m;
+    int succno = 0;
+
+    memset(scc, 0, sizeof(scc_t));
+
+    scc->comp = (int *)malloc((n + 1) * sizeof(int));
+    if (!scc->comp || tarjan(scc, graph, keep) != 0)
+        goto err;
+
+    scc->memberstart = (int *)calloc(scc->sccno + 1, sizeof(int));
+    scc->member = (int *)malloc((n + 1) * sizeof(int));
+    scc->succstart = (int *)malloc((scc->sccno + 1) * sizeof(int));
+    scc->succ = (int *)malloc((graph->branchno + 1) * sizeof(int));
+    scc->recursive = (char *)calloc(scc->sccno + 1, sizeof(char));
+    stamp = (int *)malloc((scc->sccno + 1) * sizeof(int));
+    if (!scc->memberstart || !scc->member || !scc->succstart || !scc->succ || !scc->recursive || !stamp)
+        goto err;
+
+    // group members by component, keeping them in node order
+    for (i = 0; i < n; i++)
+        if (scc->comp[i] >= 0)
+            scc->memberstart[scc->comp[i] + 1]++;
+    for (c = 0; c < scc->sccno; c++) {
+        scc->memberstart[c + 1] += scc->memberstart[c];
+        stamp[c] = scc->memberstart[c];
+    }
+    for (i = 0; i < n; i++)
+        if (scc->comp[i] >= 0)
+            scc->member[stamp[scc->comp[i]]++] = i;
+
+    // condensed edges, one per pair of distinct components
+    for (c = 0; c < scc->sccno; c++)
+        stamp[c] = -1;
+    for (c = 0; c < scc->sccno; c++) {
+        scc->succstart[c] = succno;
+        if (scc->memberstart[c + 1] - scc->memberstart[c] > 1)
+            scc->recursive[c] = 1;
+        for (m = scc->memberstart[c]; m < scc->memberstart[c + 1]; m++) {
+            i = scc->member[m];
+            for (j = graph->childstart[i]; j < graph->childstart[i + 1]; j++) {
+                d = scc->comp[graph->child[j]];
+                if (d == c)
+                    scc->recursive[c] = 1;
+                else if (d >= 0 && stamp[d] != c) {
+                    stamp[d] = c;
+                    scc->succ[succno++] = d;
+                }
+            }
+        }
+    }
+    scc->succstart[scc->sccno] = succno;
+
+    free(stamp);
+
+    return 0;
+
+err:
+    printf("\nMemory allocation error\n");
+    free(stamp);
+    scc_free(scc);
+
+    return -1;
+}
+
+static int cmp_desc(const void *l, const void *r)
+{
+    return *(const int *)r - *(const int *)l;
+}
+
+// Transitive reduction of the condensed DAG: keepsucc[j] is set to 1 when the
+// edge to succ[j] is not implied by a longer path, 0 otherwise. Successor
+// lists are sorted by decreasing index as a side effect.
+// Components are visited successors first; the successors of c are then taken
+// from the nearest (highest index) on, so an edge is redundant exactly when
+// its target is already in the reachability bitset of c.
+int scc_reduce(scc_t *scc, char *keepsucc)
+{
+    size_t words = (scc->sccno + WORDBITS - 1) / WORDBITS;
+    bitword_t *reach, *row, *drow;
+    int c, d, j;
+    size_t w;
+
+    if (words && (size_t)scc->sccno > (size_t)-1 / sizeof(bitword_t) / words) {
+        printf("\nToo many functions for the reachability matrix\n");
+        return -1;
+    }
+
+    reach = (bitword_t *)calloc(scc->sccno * words + 1, sizeof(bitword_t));
+    if (!reach) {
+        printf("\nMemory allocation error\n");
+        return -1;
+    }
+
+    for (c = 0; c < scc->sccno; c++) {
+        row = reach + c * words;
+        qsort(scc->succ + scc->succstart[c], scc->succstart[c + 1] - scc->succstart[c], sizeof(int), cmp_desc);
+        for (j = scc->succstart[c]; j < scc->succstart[c + 1]; j++) {
+            d = scc->succ[j];
+            if (BITTEST(row, d)) {
+                keepsucc[j] = 0;
+            } else {
+                keepsucc[j] = 1;
+                BITSET(row, d);
+                drow = reach + d * words;
+                for (w = 0; w < words; w++)
+                    row[w] |= drow[w];
+            }
+        }
+    }
+
+    free(reach);
+
+    return 0;
+}
@@ -0,0 +1,32 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _SCC_H
+#define _SCC_H
+
+#include "symgraph.h"
+
+typedef struct scc scc_t;
+
+// Strongly connected components of a symgraph and the condensed DAG.
+// Components are numbered in reverse topological order: every successor of
+// component c has an index lower than c.
+struct scc {
+    int sccno;        // number of components
+    int *comp;        // component of each graph node, -1 if the node was filtered out
+    int *memberstart; // members of c: member[memberstart[c] .. memberstart[c + 1] - 1]
+    int *member;
+    int *succstart;   // successors of c: succ[succstart[c] .. succstart[c + 1] - 1]
+    int *succ;
+    char *recursive;  // 1 if c is a recursive cycle: more than one member or a self call
+};
+
+int scc_build(scc_t *scc, symgraph_t *graph, const char *keep);
+void scc_free(scc_t *scc);
+int scc_reduce(scc_t *scc, char *keepsucc);
+
+#endif //  _SCC_H
@@ -85,3 +85,23 @@ int slibbasename(char **sbase, char *spath, int withext)
 
     return iErr;
 }
+
+// print a string as a quoted JSON string (null for NULL)
+void slibjson(FILE *file, char const *s)
+{
+    if (s == NULL) {
+        fputs("null", file);
+        return;
+    }
+
+    fputc('"', file);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\')
+            fprintf(file, "\\%c", *s);
+        else if ((unsigned char)*s < 0x20)
+            fprintf(file, "\\u%04x", (unsigned char)*s);
+        else
+            fputc(*s, file);
+    }
+    fputc('"', file);
+}
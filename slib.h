@@ -25,7 +25,10 @@
 #ifndef _SLIB_H
 #define _SLIB_H
 
+#include <stdio.h>
+
 int slibcpy(char **sout, char const *sin, int sin_len, int errval);
 int slibbasename(char **sbase, char *spath, int withext);
+void slibjson(FILE *file, char const *s);
 
 #endif // #ifndef _SLIB_H
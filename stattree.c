@@ -0,0 +1,186 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _ALL_IN_ONE
+#include "defines.h"
+#include "outtree.h"
+#include "slib.h"
+#include "stattree.h"
+#include "symgraph.h"
+#endif // _ALL_IN_ONE
+
+// functions with the highest degree, kept in a min-heap of at most maxno
+// items: the root is the one to be dropped first
+typedef struct statheap {
+    int *idx;
+    int *deg;
+    int no;
+    int maxno;
+} statheap_t;
+
+// 1 if a ranks below b: lower degree, or same degree and later in name order
+static int below(statheap_t *pheap, int a, int b)
+{
+    return pheap->deg[a] < pheap->deg[b] || (pheap->deg[a] == pheap->deg[b] && pheap->idx[a] > pheap->idx[b]);
+}
+
+static void swap(statheap_t *pheap, int a, int b)
+{
+    int tidx = pheap->idx[a], tdeg = pheap->deg[a];
+
+    pheap->idx[a] = pheap->idx[b];
+    pheap->deg[a] = pheap->deg[b];
+    pheap->idx[b] = tidx;
+    pheap->deg[b] = tdeg;
+}
+
+static void siftdown(statheap_t *pheap, int i)
+{
+    int l, m;
+
+    for (;;) {
+        m = i;
+        l = 2 * i + 1;
+        if (l < pheap->no && below(pheap, l, m))
+            m = l;
+        if (l + 1 < pheap->no && below(pheap, l + 1, m))
+            m = l + 1;
+        if (m == i)
+            break;
+        swap(pheap, i, m);
+        i = m;
+    }
+}
+
+static void offer(statheap_t *pheap, int idx, int deg)
+{
+    int i, p;
+
+    if (pheap->no < pheap->maxno) {
+        i = pheap->no++;
+        pheap->idx[i] = idx;
+        pheap->deg[i] = deg;
+        for (; i > 0; i = p) {
+            p = (i - 1) / 2;
+            if (!below(pheap, i, p))
+                break;
+            swap(pheap, i, p);
+        }
+    } else if (pheap->no > 0 && (deg > pheap->deg[0] || (deg == pheap->deg[0] && idx < pheap->idx[0]))) {
+        pheap->idx[0] = idx;
+        pheap->deg[0] = deg;
+        siftdown(pheap, 0);
+    }
+}
+
+// empty the heap leaving the items sorted from the highest degree
+static void drain(statheap_t *pheap)
+{
+    int no = pheap->no;
+
+    while (pheap->no > 1) {
+        swap(pheap, 0, --pheap->no);
+        siftdown(pheap, 0);
+    }
+    pheap->no = no;
+}
+
+// select the kept functions with the highest number of distinct callers
+// (fanin != 0) or callees
+static void topdegree(symgraph_t *pgraph, const char *keep, int fanin, statheap_t *pheap)
+{
+    int *start = fanin ? pgraph->parentstart : pgraph->childstart;
+    int *adj = fanin ? pgraph->parent : pgraph->child;
+    int i, j, deg;
+
+    pheap->no = 0;
+    for (i = 0; i < pgraph->nodeno; i++) {
+        if (!keep[i])
+            continue;
+        deg = 0;
+        for (j = start[i]; j < start[i + 1]; j++)
+            deg += keep[adj[j]];
+        if (deg > 0)
+            offer(pheap, i, deg);
+    }
+    drain(pheap);
+}
+
+static void printtop(symgraph_t *pgraph, statheap_t *pheap, const char *title, int json)
+{
+    symtree_node_t *pnode;
+    int i;
+
+    if (json) {
+        printf("  \"%s\": [", title);
+        for (i = 0; i < pheap->no; i++) {
+            pnode = pgraph->nodes[pheap->idx[i]];
+            printf("%s\n    {\"function\": ", i > 0 ? "," : "");
+            slibjson(stdout, pnode->funname);
+            printf(", \"file\": ");
+            slibjson(stdout, pnode->filename);
+            printf(", \"count\": %d}", pheap->deg[i]);
+        }
+        printf("%s]", pheap->no > 0 ? "\n  " : "");
+    } else {
+        printf("# %s\n", title);
+        printf("%-6s %-8s %-32s %s\n", "rank", "count", "function", "file");
+        for (i = 0; i < pheap->no; i++) {
+            pnode = pgraph->nodes[pheap->idx[i]];
+            printf("%-6d %-8d %-32s %s\n", i + 1, pheap->deg[i], pnode->funname, pnode->filename ? pnode->filename : TT_LIBRARY);
+        }
+    }
+}
+
+// report the functions with most callers (fan-in) and most callees (fan-out)
+int stattree(symtree_t *ptree, treeparam_t *pparam)
+{
+    int iErr = 0;
+    symgraph_t graph;
+    statheap_t heap;
+    char *keep;
+    int i;
+
+    iErr = symgraph_build(&graph, ptree);
+    if (iErr != 0)
+        return iErr;
+
+    memset(&heap, 0, sizeof(statheap_t));
+    heap.maxno = pparam->hotno < graph.nodeno ? pparam->hotno : graph.nodeno;
+    heap.idx = (int *)malloc((heap.maxno + 1) * sizeof(int));
+    heap.deg = (int *)malloc((heap.maxno + 1) * sizeof(int));
+    keep = (char *)malloc(graph.nodeno + 1);
+    if (heap.idx == NULL || heap.deg == NULL || keep == NULL) {
+        printf("\nMemory allocation error\n");
+        iErr = -1;
+    } else {
+        // excluded functions (-x option) are neither ranked nor counted as callers or callees
+        for (i = 0; i < graph.nodeno; i++)
+            keep[i] = !outexcluded(graph.nodes[i], pparam);
+
+        if (pparam->json)
+            printf("{\n");
+        topdegree(&graph, keep, 1, &heap);
+        printtop(&graph, &heap, "fanin", pparam->json);
+        printf(pparam->json ? ",\n" : "\n");
+        topdegree(&graph, keep, 0, &heap);
+        printtop(&graph, &heap, "fanout", pparam->json);
+        if (pparam->json)
+            printf("\n}\n");
+    }
+
+    free(heap.idx);
+    free(heap.deg);
+    free(keep);
+    symgraph_free(&graph);
+
+    return iErr;
+}
@@ -0,0 +1,204 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "symgraph.h"
+
+void symgraph_free(symgraph_t *graph)
+{
+    free(graph->nodes);
+    free(graph->childstart);
+    free(graph->child);
+    free(graph->parentstart);
+    free(graph->parent);
+    memset(graph, 0, sizeof(symgraph_t));
+}
+
+int symgraph_build(symgraph_t *graph, symtree_t *stree)
+{
+    symtree_node_t *node;
+    symtree_list_t *list;
+    int *stamp = NULL;
+    int i, j, n, c;
+    int rawno = 0;
+
+    memset(graph, 0, sizeof(symgraph_t));
+
+    // number the nodes in tree order and count the call sites
+    for (node = symtree_first(stree); node; node = symtree_next(node)) {
+        node->idx = graph->nodeno++;
+        for (list = node->children; list; list = list->next)
+            rawno++;
+    }
+
+    n = graph->nodeno;
+    graph->nodes = (symtree_node_t **)malloc((n + 1) * sizeof(symtree_node_t *));
+    graph->childstart = (int *)malloc((n + 1) * sizeof(int));
+    graph->child = (int *)malloc((rawno + 1) * sizeof(int));
+    graph->parentstart = (int *)calloc(n + 1, sizeof(int));
+    stamp = (int *)malloc((n + 1) * sizeof(int));
+    if (!graph->nodes || !graph->childstart || !graph->child || !graph->parentstart || !stamp)
+        goto err;
+
+    for (node = symtree_first(stree); node; node = symtree_next(node)) {
+        graph->nodes[node->idx] = node;
+        stamp[node->idx] = -1;
+    }
+
+    // callees, merging duplicated call sites
+    for (i = 0; i < n; i++) {
+        graph->childstart[i] = graph->branchno;
+        for (list = graph->nodes[i]->children; list; list = list->next) {
+            c = list->symbol->idx;
+            if (stamp[c] != i) {
+                stamp[c] = i;
+                graph->child[graph->branchno++] = c;
+                graph->parentstart[c + 1]++;
+            }
+        }
+    }
+    graph->childstart[n] = graph->branchno;
+
+    // callers are the transpose of the callees
+    graph->parent = (int *)malloc((graph->branchno + 1) * sizeof(int));
+    if (!graph->parent)
+        goto err;
+
+    for (i = 0; i < n; i++)
+        graph->parentstart[i + 1] += graph->parentstart[i];
+    for (i = 0; i < n; i++)
+        stamp[i] = graph->parentstart[i];
+    for (i = 0; i < n; i++)
+        for (j = graph->childstart[i]; j < graph->childstart[i + 1]; j++)
+            graph->parent[stamp[graph->child[j]]++] = i;
+
+    free(stamp);
+
+    return 0;
+
+err:
+    printf("\nMemory allocation error\n");
+    free(stamp);
+    symgraph_free(graph);
+
+    return -1;
+}
+
+// Renumber the nodes in breadth first order over callees and callers, from the
+// start nodes first (the functions without callers if start is NULL) and then
+// from the nodes not reached yet in the current order. Functions calling each
+// other get close numbers, so the traversals that follow touch nearby memory
+// instead of jumping across the arrays. The idx of the symtree nodes and the
+// start nodes are renumbered too; the order by name is lost.
+int symgraph_relabel(symgraph_t *graph, int *start, int startno)
+{
+    int n = graph->nodeno;
+    int *order = NULL; // old number of each new node, i.e. the queue of the search
+    int *newof = NULL; // new number of each old node
+    symtree_node_t **nodes = NULL;
+    int *childstart = NULL, *child = NULL, *parentstart = NULL, *parent = NULL;
+    int head = 0, tail = 0, next = 0, i, j, k, v, w;
+
+    order = (int *)malloc((n + 1) * sizeof(int));
+    newof = (int *)malloc((n + 1) * sizeof(int));
+    nodes = (symtree_node_t **)malloc((n + 1) * sizeof(symtree_node_t *));
+    childstart = (int *)malloc((n + 1) * sizeof(int));
+    child = (int *)malloc((graph->branchno + 1) * sizeof(int));
+    parentstart = (int *)malloc((n + 1) * sizeof(int));
+    parent = (int *)malloc((graph->branchno + 1) * sizeof(int));
+    if (!order || !newof || !nodes || !childstart || !child || !parentstart || !parent) {
+        printf("\nMemory allocation error\n");
+        free(order);
+        free(newof);
+        free(nodes);
+        free(childstart);
+        free(child);
+        free(parentstart);
+        free(parent);
+        return -1;
+    }
+
+    for (i = 0; i < n; i++)
+        newof[i] = -1;
+    if (start == NULL) {
+        for (i = 0; i < n; i++) {
+            if (graph->parentstart[i] == graph->parentstart[i + 1]) {
+                newof[i] = tail;
+                order[tail++] = i;
+            }
+        }
+    }
+    for (i = 0; start && i < startno; i++) {
+        if (newof[start[i]] < 0) {
+            newof[start[i]] = tail;
+            order[tail++] = start[i];
+        }
+    }
+    while (tail < n) {
+        if (head == tail) {
+            // a part of the graph not connected to the start nodes
+            while (newof[next] >= 0)
+                next++;
+            newof[next] = tail;
+            order[tail++] = next;
+        }
+        v = order[head++];
+        for (j = graph->childstart[v]; j < graph->childstart[v + 1]; j++) {
+            w = graph->child[j];
+            if (newof[w] < 0) {
+                newof[w] = tail;
+                order[tail++] = w;
+            }
+        }
+        for (j = graph->parentstart[v]; j < graph->parentstart[v + 1]; j++) {
+            w = graph->parent[j];
+            if (newof[w] < 0) {
+                newof[w] = tail;
+                order[tail++] = w;
+            }
+        }
+    }
+
+    // the lists keep their order, so the searches give the same results as before
+    for (k = 0, i = 0; i < n; i++) {
+        v = order[i];
+        nodes[i] = graph->nodes[v];
+        nodes[i]->idx = i;
+        childstart[i] = k;
+        for (j = graph->childstart[v]; j < graph->childstart[v + 1]; j++)
+            child[k++] = newof[graph->child[j]];
+    }
+    childstart[n] = k;
+    for (k = 0, i = 0; i < n; i++) {
+        v = order[i];
+        parentstart[i] = k;
+        for (j = graph->parentstart[v]; j < graph->parentstart[v + 1]; j++)
+            parent[k++] = newof[graph->parent[j]];
+    }
+    parentstart[n] = k;
+    for (i = 0; start && i < startno; i++)
+        start[i] = newof[start[i]];
+
+    free(graph->nodes);
+    free(graph->childstart);
+    free(graph->child);
+    free(graph->parentstart);
+    free(graph->parent);
+    graph->nodes = nodes;
+    graph->childstart = childstart;
+    graph->child = child;
+    graph->parentstart = parentstart;
+    graph->parent = parent;
+
+    free(order);
+    free(newof);
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+/**
+ *
+ * Copyright 2026 The tceetree authors
+ *
+ * SPDX short identifier: MIT
+ */
+
+#ifndef _SYM_GRAPH_H
+#define _SYM_GRAPH_H
+
+#include "symtree.h"
+
+typedef struct symgraph symgraph_t;
+
+// Frozen, compact (CSR) view of a symtree built once the tree is complete.
+// Nodes are numbered 0..nodeno-1 in tree order (by name), or in traversal
+// order after symgraph_relabel, and each symtree node keeps its number in
+// symtree_node_t.idx. Duplicated call sites are merged, so every caller ->
+// callee pair appears once in child[] and once in parent[].
+struct symgraph {
+    int nodeno;              // number of nodes
+    int branchno;            // number of distinct caller -> callee pairs
+    symtree_node_t **nodes;  // nodes by index
+    int *childstart;         // callees of i: child[childstart[i] .. childstart[i + 1] - 1]
+    int *child;
+    int *parentstart;        // callers of i: parent[parentstart[i] .. parentstart[i + 1] - 1]
+    int *parent;
+};
+
+int symgraph_build(symgraph_t *graph, symtree_t *stree);
+int symgraph_relabel(symgraph_t *graph, int *start, int startno);
+void symgraph_free(symgraph_t *graph);
+
+#endif //  _SYM_GRAPH_H
@@ -58,31 +58,68 @@ static int symtree_find_cmp(void *data, rb_node_t *node)
     return cmp_symtree_note_t(l, r, 1);
 }
 
-static symtree_node_t *alloc_node(char *funname, char *filename)
+// file table entry of filename: the functions of a file are added one after
+// the other, so only the last file added needs to be looked at
+static symtree_file_t *get_file(symtree_t *stree, char *filename)
 {
-    symtree_node_t *node = (symtree_node_t*)calloc(1, sizeof(symtree_node_t));
-    if (!node)
+    symtree_file_t *file;
+    char *base;
+    int i;
+
+    if (stree->files && strcmp(stree->files->name, filename) == 0)
+        return stree->files;
+
+    file = (symtree_file_t*)calloc(1, sizeof(symtree_file_t));
+    if (!file)
         return NULL;
 
-    node->funname = strdup(funname);
-    if (!node->funname)
+    // base name after the last path separator, Windows ones included
+    base = filename + strlen(filename);
+    while (base > filename && base[-1] != '/' && base[-1] != '\\')
+        base--;
+
+    file->name = strdup(filename);
+    file->basename = strdup(base);
+    file->clusterid = strdup(base);
+    if (!file->name || !file->basename || !file->clusterid)
         goto err;
-    if (filename) {
-        node->filename = strdup(filename);
-        if (!node->filename)
-            goto err;
-    }
+    for (i = 0; file->clusterid[i]; i++)
+        if (file->clusterid[i] == '.')
+            file->clusterid[i] = '_';
 
-    return node;
+    file->next = stree->files;
+    stree->files = file;
+
+    return file;
 
 err:
-    if (node->funname)
-        free(node->funname);
-    free(node);
+    free(file->name);
+    free(file->basename);
+    free(file->clusterid);
+    free(file);
 
     return NULL;
 }
 
+static symtree_node_t *alloc_node(char *funname, symtree_file_t *file)
+{
+    symtree_node_t *node = (symtree_node_t*)calloc(1, sizeof(symtree_node_t));
+    if (!node)
+        return NULL;
+
+    node->funname = strdup(funname);
+    if (!node->funname) {
+        free(node);
+        return NULL;
+    }
+    if (file) {
+        node->file = file;
+        node->filename = file->name;
+    }
+
+    return node;
+}
+
 static symtree_list_t *list_add(symtree_list_t *list, symtree_node_t *node)
 {
     symtree_list_t *l = (symtree_list_t*)malloc(sizeof(symtree_list_t));
@@ -95,13 +132,12 @@ static symtree_list_t *list_add(symtree_list_t *list, symtree_node_t *node)
     return l;
 }
 
+// free the entries of a list, not the nodes they point to
 static void list_free(symtree_list_t *list)
 {
     symtree_list_t* l = list;
     while (l) {
         l = l->next;
-        if (list->symbol)
-            free(list->symbol);
         free(list);
         list = l;
     }
@@ -112,28 +148,58 @@ void free_node(symtree_node_t *node)
     if (node) {
         if (node->funname)
             free(node->funname);
-        if (node->filename)
-            free(node->filename);
         if (node->parents)
             list_free(node->parents);
         if (node->children)
             list_free(node->children);
+        free(node);
+    }
+}
+
+// free the nodes below rbnode, children first, so that no freed node is visited
+static void free_subtree(rb_node_t *rbnode)
+{
+    if (rbnode) {
+        free_subtree(rbnode->left);
+        free_subtree(rbnode->right);
+        free_node(container_of(rbnode, symtree_node_t, node));
     }
 }
 
 void symtree_init(struct symtree *stree)
 {
     stree->root = RB_TREE_INIT(symtree_insert_cmp, symtree_find_cmp);
+    stree->files = NULL;
 }
 
 void symtree_free(struct symtree *stree)
 {
-    // TODO;
+    symtree_file_t *file;
+
+    free_subtree(stree->root.node);
+    stree->root.node = NULL;
+    while (stree->files) {
+        file = stree->files;
+        stree->files = file->next;
+        free(file->name);
+        free(file->basename);
+        free(file->clusterid);
+        free(file);
+    }
 }
 
 symtree_node_t *symtree_add(symtree_t *stree, char *funname, char *filename)
 {
-    symtree_node_t *symbol = alloc_node(funname, filename);
+    symtree_file_t *file = NULL;
+    symtree_node_t *symbol;
+
+    if (filename) {
+        file = get_file(stree, filename);
+        if (!file)
+            return NULL;
+    }
+
+    symbol = alloc_node(funname, file);
     if (!symbol)
         return NULL;
 
@@ -162,6 +228,26 @@ symtree_node_t *symtree_find(symtree_t *stree, char *funname, char *filename)
     return container_of(rbnode, symtree_node_t, node);
 }
 
+// first of the nodes defining funname (in any file); the others follow it
+// in symtree_next() order
+symtree_node_t *symtree_find_first(symtree_t *stree, char *funname)
+{
+    rb_node_t *rbnode;
+    symtree_node_t symbol = {
+        .funname = funname,
+        .filename = NULL,
+    };
+
+    if (!funname)
+        return NULL;
+
+    rbnode = rb_tree_find_first(&(stree->root), &symbol);
+    if (rbnode)
+        return container_of(rbnode, symtree_node_t, node);
+
+    return NULL;
+}
+
 void symtree_node_add_branch(symtree_node_t *caller, symtree_node_t *callee)
 {
     caller->children = list_add(caller->children, callee);
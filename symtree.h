@@ -13,26 +13,38 @@
 typedef struct symtree symtree_t;
 typedef struct symtree_node symtree_node_t;
 typedef struct symtree_list symtree_list_t;
+typedef struct symtree_file symtree_file_t;
 
 struct symtree_list {
     struct symtree_list *next;
     struct symtree_node *symbol;
 };
 
+// source file shared by the functions defined in it, with the names the
+// output needs worked out once
+struct symtree_file {
+    char *name;      // path as found in the cscope file
+    char *basename;  // name without path, with extension
+    char *clusterid; // basename with '.' replaced by '_'
+    struct symtree_file *next;
+};
+
 struct symtree_node {
     rb_node_t node;
     char *funname;
-    char *filename;
-    int outdone;
-    int subtreeoutdone;
+    char *filename;        // file->name, NULL for library functions
+    symtree_file_t *file;  // NULL for library functions
     int isroot;
     int icolor;
+    int outlisted; // one bit for each output file listing it: as a node, or in the cluster of its file (-F option)
+    int idx;       // index in the frozen graph, see symgraph.h
     struct symtree_list *parents;
     struct symtree_list *children;
 };
 
 struct symtree {
     struct rb_tree root;
+    symtree_file_t *files; // file table, last added first
 };
 
 void symtree_init(symtree_t *stree);
@@ -42,6 +54,7 @@ symtree_node_t *symtree_next(symtree_node_t *node);
 
 symtree_node_t *symtree_add(symtree_t *stree, char *funname, char *filename);
 symtree_node_t *symtree_find(symtree_t *stree, char *funname, char *filename);
+symtree_node_t *symtree_find_first(symtree_t *stree, char *funname);
 void symtree_node_add_branch(symtree_node_t *caller, symtree_node_t *callee);
 
 #endif //  _SYM_TREE_H
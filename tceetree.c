@@ -27,10 +27,17 @@
 #include <string.h>
 
 #ifndef _ALL_IN_ONE
+#include "blasttree.h"
+#include "deadtree.h"
 #include "defines.h"
+#include "depthtree.h"
+#include "difftree.h"
 #include "gettree.h"
 #include "outtree.h"
+#include "parmark.h"
+#include "querytree.h"
 #include "slib.h"
+#include "stattree.h"
 #include "symtree.h"
 #include "ttreeparam.h"
 #endif // _ALL_IN_ONE
@@ -38,6 +45,9 @@
 const char sversion[] = "1.0.1";               // software version
 const char sdefaultoutfile[] = "tceetree.out"; // default output file
 
+// names of the output types, in the order of treeouttype_t
+const char *souttypes[TREEOUT_MAXNUM] = { "graphviz", "ndjson", "csv", "graphml", "stats", "svg", "neato" };
+
 // setting of string parameters
 int paramstr(char **sout, char const *sin)
 {
@@ -55,32 +65,144 @@ int paramstrarr(char **sout, int *outidx, int maxnum, char const *sin, char cons
     return slibcpy(&sout[(*outidx)++], sin, 0, -3);
 }
 
+// setting of an output file parameter, "type:file" or "file" of the type of -t
+int paramout(treeparam_t *ptreeparam, char const *sin)
+{
+    int i, iErr;
+    size_t len = 0;
+
+    // the prefix is a type only if it is one of the names, so c:\calls.dot is a file
+    for (i = 0; i < TREEOUT_MAXNUM; i++) {
+        len = strlen(souttypes[i]);
+        if (strncmp(sin, souttypes[i], len) == 0 && sin[len] == ':')
+            break;
+    }
+
+    if (i < TREEOUT_MAXNUM)
+        sin += len + 1;
+    else
+        i = -1;
+    iErr = paramstrarr(ptreeparam->outfiles, &ptreeparam->outno, TT_MAXOUTS, sin, "\nThe maximum number of output files is %d\n");
+    if (iErr == 0)
+        ptreeparam->outtypes[ptreeparam->outno - 1] = i;
+
+    return iErr;
+}
+
+// setting of the output files: the default one if none is given, each of the
+// type of -t unless given; the first one is also the output file parameter
+int paramoutputs(treeparam_t *ptreeparam)
+{
+    int i, iErr = 0;
+
+    if (ptreeparam->outno == 0) {
+        iErr = paramstrarr(ptreeparam->outfiles, &ptreeparam->outno, TT_MAXOUTS, ptreeparam->outfile, "");
+        ptreeparam->outtypes[0] = -1;
+    }
+
+    for (i = 0; i < ptreeparam->outno; i++)
+        if (ptreeparam->outtypes[i] < 0)
+            ptreeparam->outtypes[i] = ptreeparam->outtype;
+
+    if (iErr == 0) {
+        iErr = paramstr(&ptreeparam->outfile, ptreeparam->outfiles[0]);
+        ptreeparam->outtype = (treeouttype_t)ptreeparam->outtypes[0];
+    }
+
+    return iErr;
+}
+
+// selection of a report mode
+void parammode(treeparam_t *ptreeparam, treemode_t mode)
+{
+    ptreeparam->mode = mode;
+    ptreeparam->modes |= 1 << mode;
+}
+
 // setting of default parameters
 void paramdefault(treeparam_t *ptreeparam)
 {
     memset(ptreeparam, 0, sizeof(treeparam_t));
     ptreeparam->fdepth = -1;                         // default for called functions depth is maximum
+    ptreeparam->jobs = 1;                            // default is single threaded
     paramstr(&ptreeparam->infile, "cscope.out");     // if no input file is specified, default is "cscope.out"
     paramstr(&ptreeparam->outfile, sdefaultoutfile); // default output file
     paramstr(&ptreeparam->shortdbfile, "");          // default shortened output file
+    ptreeparam->mode = TREEMODE_OUTPUT;              // default is graph output
     ptreeparam->outtype = TREEOUT_GRAPHVIZ;          // default is output for graphviz
 }
 
 // parameter cross checks
 int paramcrosscheck(treeparam_t *ptreeparam)
 {
-    if (strcmp(ptreeparam->infile, ptreeparam->outfile) == 0) {
-        printf("\nThe input file cannot be the same as the output file\n");
+    int i, j;
+
+    if (ptreeparam->modes & (ptreeparam->modes - 1)) {
+        printf("\nOnly one of the reports -B, -D, -H, -q, -u and -W can be made at a time\n");
         return -1;
     }
 
+    for (i = 0; i < ptreeparam->outno; i++) {
+        if (strcmp(ptreeparam->infile, ptreeparam->outfiles[i]) == 0) {
+            printf("\nThe input file cannot be the same as the output file\n");
+            return -1;
+        }
+
+        if (strcmp(ptreeparam->outfiles[i], ptreeparam->shortdbfile) == 0) {
+            printf("\nThe output file cannot be the same as the shortened cscope output file\n");
+            return -1;
+        }
+
+        for (j = 0; j < i; j++) {
+            if (strcmp(ptreeparam->outfiles[i], ptreeparam->outfiles[j]) == 0) {
+                printf("\nThe output files must be different\n");
+                return -1;
+            }
+        }
+    }
+
     if (strcmp(ptreeparam->infile, ptreeparam->shortdbfile) == 0) {
         printf("\nThe input file cannot be the same as the shortened cscope output file\n");
         return -1;
     }
 
-    if (strcmp(ptreeparam->outfile, ptreeparam->shortdbfile) == 0) {
-        printf("\nThe output file cannot be the same as the shortened cscope output file\n");
+    if (ptreeparam->pathno > 0 && ptreeparam->callp == NULL) {
+        printf("\nThe number of paths needs a path to be highlighted (-p)\n");
+        return -1;
+    }
+
+    if (ptreeparam->minsamples > 0 && ptreeparam->proffile == NULL) {
+        printf("\nThe minimum number of samples needs a profile file (-P)\n");
+        return -1;
+    }
+
+    if (ptreeparam->moddepth > 0 && (ptreeparam->callp || ptreeparam->proffile || ptreeparam->condense || ptreeparam->reduce)) {
+        printf("\nThe module graph (-M) cannot be combined with -p, -P, -S or -T\n");
+        return -1;
+    }
+
+    if (ptreeparam->maxnodes > 0 && (ptreeparam->pathno > 0 || ptreeparam->moddepth > 0 || ptreeparam->proffile || ptreeparam->condense)) {
+        printf("\nThe node budget (-n) cannot be combined with -k, -M, -P or -S\n");
+        return -1;
+    }
+
+    if (ptreeparam->pagesize > 0 && (ptreeparam->doclusters || ptreeparam->pathno > 0 || ptreeparam->moddepth > 0 || ptreeparam->maxnodes > 0 || ptreeparam->proffile || ptreeparam->condense || ptreeparam->reduce)) {
+        printf("\nThe pages (-g) cannot be combined with -F, -k, -M, -n, -P, -S or -T\n");
+        return -1;
+    }
+
+    if (ptreeparam->pagesize > 0 && ptreeparam->outtype != TREEOUT_GRAPHVIZ) {
+        printf("\nThe pages (-g) are written for graphviz only (-t graphviz)\n");
+        return -1;
+    }
+
+    if (ptreeparam->pagesize > 0 && ptreeparam->outno > 1) {
+        printf("\nThe pages (-g) are written for one output file only (-o)\n");
+        return -1;
+    }
+
+    if (ptreeparam->proffile && (ptreeparam->callp || ptreeparam->condense || ptreeparam->reduce)) {
+        printf("\nThe profile output (-P) cannot be combined with -p, -S or -T\n");
         return -1;
     }
 
@@ -96,32 +218,82 @@ void paramfree(treeparam_t *ptreeparam)
     free(ptreeparam->outfile);
     free(ptreeparam->shortdbfile);
     free(ptreeparam->callp);
+    free(ptreeparam->queryfile);
+    free(ptreeparam->rootfile);
+    free(ptreeparam->difffile);
+    free(ptreeparam->proffile);
 
     for (i = 0; i < ptreeparam->rootno; i++)
         free(ptreeparam->root[i]);
     for (i = 0; i < ptreeparam->excludfno; i++)
         free(ptreeparam->excludf[i]);
+    for (i = 0; i < ptreeparam->outno; i++)
+        free(ptreeparam->outfiles[i]);
 }
 
 // print usage help
 void usage(void)
 {
     printf("\n");
-    printf("Usage: tceetree [-c <depth>] [-C <depth>] [-d <file>] [-f] [-F] [-h]\n"
-           "                [-i <file>] [-o <file>] [-p <function>] [-r <root>]\n"
-           "                [-s <style>] [-v] [-V] [-x <function>]\n\n");
+    printf("Usage: tceetree [-B] [-c <depth>] [-C <depth>] [-d <file>] [-D <file>] [-f]\n"
+           "                [-F] [-g <number>] [-h] [-H <number>] [-i <file>] [-j <jobs>]\n"
+           "                [-J] [-k <number>] [-M <depth>] [-n <number>] [-o <file>]\n"
+           "                [-p <function>] [-P <file>] [-q <file>] [-r <root>]\n"
+           "                [-s <style>] [-S] [-t <type>] [-T] [-u <file>] [-v] [-V]\n"
+           "                [-w <samples>] [-W] [-x <function>]\n\n");
+    printf("-B            Print for every function the estimated number of functions it\n"
+           "              calls and of functions calling it, directly or indirectly,\n"
+           "              instead of the graph output (about 10%% error).\n");
     printf("-c <depth>    Depth of tree for called functions: default is max.\n");
     printf("-C <depth>    Depth of tree for calling functions: default is 0.\n");
     printf("-d <file>     Output a shortened cscope output file: default is no output.\n"
            "              The shortened file includes only function information and can\n"
            "              be used as input (-i) for following calls to tceetree to\n"
            "              increase speed on big projects.\n");
+    printf("-D <file>     Print the functions and calls added (+) and removed (-) since\n"
+           "              the old cscope output file, instead of the graph output.\n"
+           "              With -r only those within -c/-C depth of the roots.\n");
     printf("-f            Print the file name where the call is near to branch.\n");
     printf("-F            Group functions into one cluster for each source file.\n");
+    printf("-g <number>   Split the output into pages of at most number (>= 2) nodes,\n"
+           "              each written to its own file named after the output file\n"
+           "              with _1, _2, ... before the extension. The calls to and from\n"
+           "              other pages end in one dashed box per page, counted as a\n"
+           "              node; the output file shows the pages and the calls between\n"
+           "              them.\n");
     printf("-h            Print this help.\n");
+    printf("-H <number>   Print the number of functions with most distinct callers\n"
+           "              (fan-in) and with most distinct callees (fan-out) instead\n"
+           "              of the graph output.\n");
     printf("-i <file>     Input cscope output file: default is cscope.out.\n");
-    printf("-o <file>     Output file for graphviz: default is %s.\n", sdefaultoutfile);
+    printf("-j <jobs>     Number of threads for -B, for selecting the functions of the\n"
+           "              graph output, -S, -T or -u when scanning in one direction,\n"
+           "              for formatting the graphviz output and for writing the pages\n"
+           "              of -g (max %d): default is 1.\n",
+        PARMARK_MAXJOBS);
+    printf("-J            Print the -B or -H report as JSON.\n");
+    printf("-k <number>   With -p, output only the given number of shortest call paths\n"
+           "              from the roots to the function (max %d).\n",
+        TT_MAXPATHS);
+    printf("-M <depth>    Output the calls between modules instead of functions: a\n"
+           "              module is a directory cut to depth components. Without -r\n"
+           "              all the functions are aggregated.\n");
+    printf("-n <number>   Output at most number nodes: the functions nearest to the\n"
+           "              roots, the most connected first, and for each of them a\n"
+           "              summary node of the functions left out behind it.\n");
+    printf("-o <file>     Output file: default is %s. Names ending in .gz or .zst\n"
+           "              are compressed with gzip or zstd. This option may occur\n"
+           "              more than once (max %d) to write several files with one\n"
+           "              scan of the tree; a type in front of the name, as in\n"
+           "              csv:calls.csv, is used for that file instead of -t.\n",
+        sdefaultoutfile, TT_MAXOUTS);
     printf("-p <function> Highlight call path till function.\n");
+    printf("-P <file>     Output only the calls sampled in the profile file, labelled\n"
+           "              with their samples and highlighted the more, the hotter they\n"
+           "              are. Lines are \"caller callee samples\" or folded stacks,\n"
+           "              \"caller;callee;... samples\".\n");
+    printf("-q <file>     Answer the reachability queries in file, one \"caller callee\"\n"
+           "              pair per line, printing yes, no or unknown for each.\n");
     printf("-r <root>     Root function of tree: default is main. This option may occur\n"
            "              more than once for multiple roots (max %d).\n",
         TT_MAXROOTS);
@@ -132,8 +304,31 @@ void usage(void)
            "              - 3 = bold;\n"
            "              - 4 = dashed;\n"
            "              - 5 = dotted.\n");
+    printf("-S            Collapse recursive call cycles: one node for each strongly\n"
+           "              connected component, listing its member functions.\n");
+    printf("-t <type>     Type of output file:\n"
+           "              - graphviz = input for graphviz dot (default);\n"
+           "              - ndjson = one JSON object per line for each node and branch;\n"
+           "              - csv = branch list, with the node list in a second file\n"
+           "                named with .nodes before the extension;\n"
+           "              - graphml = GraphML file;\n"
+           "              - stats = counts of the nodes and branches, as one JSON\n"
+           "                object;\n"
+           "              - svg = drawing laid out by tceetree, without graphviz;\n"
+           "              - neato = graphviz input laid out by tceetree, with the\n"
+           "                node positions: draw it with neato -n.\n");
+    printf("-T            Transitive reduction: print all the calls between the selected\n"
+           "              functions but those implied by longer call chains; more calls\n"
+           "              than the default output, which is a tree.\n");
+    printf("-u <file>     List the functions defined in the source files that cannot be\n"
+           "              reached from the roots nor from the entry points listed in\n"
+           "              file, one function name per line (no limit).\n");
     printf("-v            Print version.\n");
     printf("-V            Verbose output.\n");
+    printf("-w <samples>  With -P, leave out the calls with fewer samples: default is 1.\n");
+    printf("-W            Print the worst-case call chain depth from each root, with an\n"
+           "              example chain, instead of the graph output. Chains reaching\n"
+           "              a recursive cycle are reported as unbounded.\n");
     printf("-x <function> Function to be excluded from tree. This option may occur more\n"
            "              than once for multiple functions (max %d).\n"
            "              -x %s is a special case for excluding all library\n"
@@ -147,6 +342,7 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
     static char curopt = 0; // holds option currently being parsed (e.g. 'd')
     int iErr = 0;
     int isoptval; // = 1 when decoding value of option
+    int i;
 
     if (curopt == 0 && (sopt[0] != '-' || strlen(sopt) != 2))
         iErr = -1;
@@ -155,6 +351,11 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
         if (!isoptval)
             curopt = sopt[1];
         switch (curopt) {
+        case 'B':
+            parammode(ptreeparam, TREEMODE_BLAST);
+            curopt = 0;
+            break;
+
         case 'c':
             if (isoptval) {
                 if (strcmp(sopt, "max") == 0)
@@ -186,6 +387,14 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
             }
             break;
 
+        case 'D':
+            if (isoptval) {
+                iErr = paramstr(&ptreeparam->difffile, sopt);
+                parammode(ptreeparam, TREEMODE_DIFF);
+                curopt = 0;
+            }
+            break;
+
         case 'f':
             ptreeparam->printfile = 1;
             curopt = 0;
@@ -196,12 +405,33 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
             curopt = 0;
             break;
 
+        case 'g':
+            if (isoptval) {
+                if (sscanf(sopt, "%d", &ptreeparam->pagesize) != 1 || ptreeparam->pagesize < 2) {
+                    printf("\nNumber of nodes of a page must be a number >= 2\n");
+                    iErr = -3;
+                }
+                curopt = 0;
+            }
+            break;
+
         case 'h':
             usage();
             iErr = -2;
             curopt = 0;
             break;
 
+        case 'H':
+            if (isoptval) {
+                if (sscanf(sopt, "%d", &ptreeparam->hotno) != 1 || ptreeparam->hotno < 1) {
+                    printf("\nNumber of hotspots must be a number >= 1\n");
+                    iErr = -3;
+                }
+                parammode(ptreeparam, TREEMODE_STATS);
+                curopt = 0;
+            }
+            break;
+
         case 'i':
             if (isoptval) {
                 iErr = paramstr(&ptreeparam->infile, sopt);
@@ -209,9 +439,54 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
             }
             break;
 
+        case 'j':
+            if (isoptval) {
+                if (sscanf(sopt, "%d", &ptreeparam->jobs) != 1 || ptreeparam->jobs < 1 || ptreeparam->jobs > PARMARK_MAXJOBS) {
+                    printf("\nNumber of jobs must be a number >= 1 and <= %d\n", PARMARK_MAXJOBS);
+                    iErr = -3;
+                }
+                curopt = 0;
+            }
+            break;
+
+        case 'J':
+            ptreeparam->json = 1;
+            curopt = 0;
+            break;
+
+        case 'k':
+            if (isoptval) {
+                if (sscanf(sopt, "%d", &ptreeparam->pathno) != 1 || ptreeparam->pathno < 1 || ptreeparam->pathno > TT_MAXPATHS) {
+                    printf("\nNumber of paths must be a number >= 1 and <= %d\n", TT_MAXPATHS);
+                    iErr = -3;
+                }
+                curopt = 0;
+            }
+            break;
+
+        case 'M':
+            if (isoptval) {
+                if (sscanf(sopt, "%d", &ptreeparam->moddepth) != 1 || ptreeparam->moddepth < 1) {
+                    printf("\nModule depth must be a number >= 1\n");
+                    iErr = -3;
+                }
+                curopt = 0;
+            }
+            break;
+
+        case 'n':
+            if (isoptval) {
+                if (sscanf(sopt, "%d", &ptreeparam->maxnodes) != 1 || ptreeparam->maxnodes < 2) {
+                    printf("\nMaximum number of nodes must be a number >= 2\n");
+                    iErr = -3;
+                }
+                curopt = 0;
+            }
+            break;
+
         case 'o':
             if (isoptval) {
-                iErr = paramstr(&ptreeparam->outfile, sopt);
+                iErr = paramout(ptreeparam, sopt);
                 curopt = 0;
             }
             break;
@@ -223,6 +498,21 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
             }
             break;
 
+        case 'P':
+            if (isoptval) {
+                iErr = paramstr(&ptreeparam->proffile, sopt);
+                curopt = 0;
+            }
+            break;
+
+        case 'q':
+            if (isoptval) {
+                iErr = paramstr(&ptreeparam->queryfile, sopt);
+                parammode(ptreeparam, TREEMODE_QUERY);
+                curopt = 0;
+            }
+            break;
+
         case 'r':
             if (isoptval) {
                 iErr = paramstrarr(ptreeparam->root, &ptreeparam->rootno, TT_MAXROOTS, sopt, "\nThe maximum number of root functions is %d\n");
@@ -240,6 +530,38 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
             }
             break;
 
+        case 'S':
+            ptreeparam->condense = 1;
+            curopt = 0;
+            break;
+
+        case 't':
+            if (isoptval) {
+                for (i = 0; i < TREEOUT_MAXNUM && strcmp(sopt, souttypes[i]) != 0; i++)
+                    ;
+                if (i == TREEOUT_MAXNUM) {
+                    printf("\nOutput type must be graphviz, ndjson, csv, graphml, stats, svg or neato\n");
+                    iErr = -3;
+                } else {
+                    ptreeparam->outtype = (treeouttype_t)i;
+                }
+                curopt = 0;
+            }
+            break;
+
+        case 'T':
+            ptreeparam->reduce = 1;
+            curopt = 0;
+            break;
+
+        case 'u':
+            if (isoptval) {
+                iErr = paramstr(&ptreeparam->rootfile, sopt);
+                parammode(ptreeparam, TREEMODE_DEAD);
+                curopt = 0;
+            }
+            break;
+
         case 'v':
             printf("\n%s\n", sversion);
             iErr = -2;
@@ -251,6 +573,21 @@ int usage_opt(char const *sopt, treeparam_t *ptreeparam)
             curopt = 0;
             break;
 
+        case 'w':
+            if (isoptval) {
+                if (sscanf(sopt, "%ld", &ptreeparam->minsamples) != 1 || ptreeparam->minsamples < 1) {
+                    printf("\nMinimum number of samples must be a number >= 1\n");
+                    iErr = -3;
+                }
+                curopt = 0;
+            }
+            break;
+
+        case 'W':
+            parammode(ptreeparam, TREEMODE_DEPTH);
+            curopt = 0;
+            break;
+
         case 'x':
             if (isoptval) {
                 iErr = paramstrarr(ptreeparam->excludf, &ptreeparam->excludfno, TT_MAXEXCLUDF, sopt, "\nThe maximum number of excluded functions is %d\n");
@@ -287,11 +624,15 @@ int main(int argc, char *argv[])
             break;
     }
 
+    if (iErr == 0)
+        iErr = paramoutputs(&treeparam);
+
     if (iErr == 0)
         iErr = paramcrosscheck(&treeparam);
 
     if (iErr == 0) {
-        if (treeparam.rootno == 0) {
+        // a diff or a module graph without roots covers the whole graphs
+        if (treeparam.rootno == 0 && treeparam.mode != TREEMODE_DIFF && treeparam.moddepth == 0) {
             paramstr(&treeparam.root[0], "main"); // if no root is specified then start from main
             treeparam.rootno = 1;
         }
@@ -299,8 +640,37 @@ int main(int argc, char *argv[])
         symtree_init(&stree); // initialize tree
 
         iErr = gettree(&stree, &treeparam); // read cscope file and get the whole tree
-        if (iErr == 0)
-            iErr = outtree(&stree, &treeparam); // make subtree output according to options
+        if (iErr == 0) {
+            switch (treeparam.mode) {
+            case TREEMODE_QUERY:
+                iErr = querytree(&stree, &treeparam); // answer reachability queries
+                break;
+
+            case TREEMODE_DIFF:
+                iErr = difftree(&stree, &treeparam); // compare with the old cscope file
+                break;
+
+            case TREEMODE_DEAD:
+                iErr = deadtree(&stree, &treeparam); // list the unreachable functions
+                break;
+
+            case TREEMODE_BLAST:
+                iErr = blasttree(&stree, &treeparam); // estimate the blast radius of every function
+                break;
+
+            case TREEMODE_STATS:
+                iErr = stattree(&stree, &treeparam); // report the fan-in/fan-out hotspots
+                break;
+
+            case TREEMODE_DEPTH:
+                iErr = depthtree(&stree, &treeparam); // report the deepest call chains
+                break;
+
+            default:
+                iErr = outtree(&stree, &treeparam); // make subtree output according to options
+                break;
+            }
+        }
 
         symtree_free(&stree); // free tree memory
     }
@@ -28,31 +28,70 @@
 #define TT_MAXROOTS 5    // maximum number of roots
 #define TT_MAXSTYLES 6   // maximum number of styles + colors
 #define TT_MAXEXCLUDF 20 // maximum number of functions that can be excluded from tree
+#define TT_MAXPATHS 100  // maximum number of shortest call paths
+#define TT_MAXOUTS 8     // maximum number of output files
 
 #define TT_LIBRARY "LIBRARY" // name for library functions cluster
 
-// maybe in the future we will have output for tools different from graphviz:
+// format of the output file
 typedef enum treeouttype_e {
-    TREEOUT_GRAPHVIZ, // graphviz output file
+    TREEOUT_GRAPHVIZ, // graphviz output file (default)
+    TREEOUT_NDJSON,   // one JSON object per node and branch
+    TREEOUT_CSV,      // CSV branch list, plus a node list file
+    TREEOUT_GRAPHML,  // GraphML file
+    TREEOUT_STATS,    // counts of the nodes and branches, as one JSON object
+    TREEOUT_SVG,      // drawing laid out by tceetree
+    TREEOUT_NEATO,    // graphviz input laid out by tceetree, for neato -n
     TREEOUT_MAXNUM    // valid values below this
 } treeouttype_t;
 
+// what to do with the tree once it has been read
+typedef enum treemode_e {
+    TREEMODE_OUTPUT, // output file for graphviz (default)
+    TREEMODE_QUERY,  // answer reachability queries
+    TREEMODE_DEPTH,  // worst-case call chain depth report
+    TREEMODE_DEAD,   // unreachable functions report
+    TREEMODE_STATS,  // fan-in/fan-out hotspots report
+    TREEMODE_BLAST,  // estimated number of callees and callers of every function
+    TREEMODE_DIFF,   // calls added and removed since another cscope file
+    TREEMODE_MAXNUM  // valid values below this
+} treemode_t;
+
 typedef struct treeparam_st {
+    treemode_t mode;              // what to do with the tree
+    int modes;                    // one bit for each report mode selected, to reject conflicting ones
     treeouttype_t outtype;        // type of output file
     int printfile;                // print filename of call near to branch if != 0
     int doclusters;               // group functions into a cluster for each source file
+    int condense;                 // collapse each strongly connected component into one node
+    int reduce;                   // leave out calls implied by longer call chains
+    int moddepth;                 // path components of the modules to aggregate the functions into (0 = none)
+    int maxnodes;                 // maximum number of nodes of the output (0 = no limit)
+    int pagesize;                 // maximum number of functions of each page (0 = no pages)
     int fdepth;                   // depth of callees tree (-1 = maximum)
     int bdepth;                   // depth of callers tree (-1 = maximum)
     char *infile;                 // input file (not compressed cscope output file)
     char *outfile;                // output file to use as input for graphviz-dot
+    char *outfiles[TT_MAXOUTS];   // output files, all written by the same traversal
+    int outtypes[TT_MAXOUTS];     // type of each output file (-1 = outtype)
+    int outno;                    // number of output files
     char *shortdbfile;            // shortened cscope output file
+    char *queryfile;              // file of "caller callee" reachability queries
+    char *rootfile;               // file of entry points for the unreachable functions report
+    char *difffile;               // old cscope output file to compare the input file with
+    char *proffile;               // profile file of caller -> callee sample counts
+    long minsamples;              // calls of the profile with fewer samples are left out
     char *root[TT_MAXROOTS];      // root function names
     int rootno;                   // number of root functions
     char *callp;                  // highlighted call path function name
     int hlstyle;                  // highlight style
+    int pathno;                   // number of shortest call paths to output (0 = highlight all paths)
     char *excludf[TT_MAXEXCLUDF]; // functions to be excluded from tree
     int excludfno;                // number of functions to be excluded from tree
+    int hotno;                    // number of functions in the hotspots report
+    int json;                     // print reports as JSON
     int verbose;                  // verbose output
+    int jobs;                     // number of threads for marking the selected functions
 } treeparam_t;
 
 #endif // #ifndef _TTREEPARAM_H